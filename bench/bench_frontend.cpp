@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <ostream>
+#include <string>
+#include "bench_sources.hpp"
+#include "bloch/lexer/lexer.hpp"
+#include "bloch/parser/parser.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/semantics/semantic_analyser.hpp"
+
+using namespace bloch;
+
+static std::unique_ptr<Program> parseSource(const std::string& src) {
+    Lexer lexer(src);
+    Parser parser(lexer);
+    return parser.parse();
+}
+
+// Lexing, parsing and freeing a program of N functions
+static void BM_ParseProgram(benchmark::State& state) {
+    const std::string src = bench::generateClassicalProgram(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        auto program = parseSource(src);
+        benchmark::DoNotOptimize(program.get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * src.size()));
+}
+BENCHMARK(BM_ParseProgram)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// One semantic analysis pass over an already parsed program
+static void BM_AnalyseProgram(benchmark::State& state) {
+    auto program = parseSource(bench::generateClassicalProgram(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        SemanticAnalyser analyser;
+        analyser.analyse(*program);
+    }
+}
+BENCHMARK(BM_AnalyseProgram)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Executing every function once, which walks the whole tree
+static void BM_EvaluateProgram(benchmark::State& state) {
+    auto program = parseSource(bench::generateClassicalProgram(static_cast<int>(state.range(0))));
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    std::ostream discard(nullptr);
+    for (auto _ : state) {
+        RuntimeEvaluator evaluator(discard);
+        evaluator.execute(*program);
+    }
+}
+BENCHMARK(BM_EvaluateProgram)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "bloch/lexer/lexer.hpp"
+#include "bloch/lexer/source_file.hpp"
+#include "bloch/parser/parser.hpp"
+#include "bench_sources.hpp"
+
+using namespace bloch;
+using bloch::bench::generateSource;
+
+static void BM_Tokenize(benchmark::State& state) {
+    const std::string src = generateSource(static_cast<size_t>(state.range(0)) << 20);
+    size_t tokens = 0;
+    for (auto _ : state) {
+        Lexer lexer(src);
+        auto result = lexer.tokenize();
+        tokens = result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * src.size()));
+    state.counters["tokens/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * tokens), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Tokenize)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+// Keyword recognition dominates on a source made only of words
+static void BM_TokenizeIdentifiers(benchmark::State& state) {
+    const std::string src = bench::generateIdentifierSource(size_t(4) << 20);
+    size_t tokens = 0;
+    for (auto _ : state) {
+        Lexer lexer(src);
+        auto result = lexer.tokenize();
+        tokens = result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * src.size()));
+    state.counters["tokens/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * tokens), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TokenizeIdentifiers)->Unit(benchmark::kMillisecond);
+
+// Whitespace and comment skipping dominates on generated, indented code
+static void BM_TokenizeIndented(benchmark::State& state) {
+    const std::string src = bench::generateIndentedSource(size_t(4) << 20);
+    size_t tokens = 0;
+    for (auto _ : state) {
+        Lexer lexer(src);
+        auto result = lexer.tokenize();
+        tokens = result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * src.size()));
+    state.counters["tokens/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * tokens), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TokenizeIndented)->Unit(benchmark::kMillisecond);
+
+// Parses a 16 MB source: 0 tokenizes it into a vector first, 1 streams
+// tokens from the lexer into the parser
+static void BM_LexAndParse(benchmark::State& state) {
+    const std::string src = generateSource(size_t(16) << 20);
+    for (auto _ : state) {
+        Lexer lexer(src);
+        auto program =
+            state.range(0) == 0 ? Parser(lexer.tokenize()).parse() : Parser(lexer).parse();
+        benchmark::DoNotOptimize(program.get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * src.size()));
+}
+BENCHMARK(BM_LexAndParse)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Loading a 16 MB file: 0 reads it through istreambuf_iterator, 1 maps it
+// with SourceFile. Both touch every byte so the comparison includes faults.
+static void BM_LoadSource(benchmark::State& state) {
+    const std::string path = "bench_lexer_" + std::to_string(::getpid()) + ".bloch";
+    const std::string src = generateSource(size_t(16) << 20);
+    std::ofstream(path, std::ios::binary) << src;
+    for (auto _ : state) {
+        size_t newlines = 0;
+        if (state.range(0) == 0) {
+            std::ifstream in(path, std::ios::binary);
+            std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            for (char c : text) newlines += c == '\n';
+        } else {
+            SourceFile source(path);
+            for (char c : source.text()) newlines += c == '\n';
+        }
+        benchmark::DoNotOptimize(newlines);
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * src.size()));
+}
+BENCHMARK(BM_LoadSource)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
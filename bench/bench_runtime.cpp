@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "bloch/lexer/lexer.hpp"
+#include "bloch/parser/parser.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/semantics/semantic_analyser.hpp"
+
+using namespace bloch;
+
+static std::unique_ptr<Program> parseProgram(const std::string& src) {
+    Lexer lexer(src);
+    Parser parser(lexer);
+    auto program = parser.parse();
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    return program;
+}
+
+// Nested classical loops exercising variable lookup, assignment and arithmetic
+static void BM_ClassicalLoop(benchmark::State& state) {
+    const std::string n = std::to_string(state.range(0));
+    const std::string src =
+        "function main() -> void { int total = 0; for (int i = 0; i < " + n +
+        "; i = i + 1) { for (int j = 0; j < 10; j = j + 1) { total = total + i * j % 7; } } }";
+    auto program = parseProgram(src);
+    for (auto _ : state) {
+        RuntimeEvaluator evaluator;
+        evaluator.execute(*program);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 10);
+}
+BENCHMARK(BM_ClassicalLoop)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Loop-invoked function calls exercising frame setup and argument passing
+static void BM_FunctionCalls(benchmark::State& state) {
+    const std::string n = std::to_string(state.range(0));
+    const std::string src =
+        "function inc(int v, int step) -> int { return v + step; } function main() -> void { "
+        "int total = 0; for (int i = 0; i < " +
+        n + "; i = i + 1) { total = inc(total, i); } }";
+    auto program = parseProgram(src);
+    for (auto _ : state) {
+        RuntimeEvaluator evaluator;
+        evaluator.execute(*program);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FunctionCalls)->Arg(1000)->Arg(10000);
@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+#include <complex>
+#include <cstdlib>
+#include "bloch/runtime/qasm_simulator.hpp"
+
+using namespace bloch;
+
+// Per-kernel benchmarks for QasmSimulator. Qubit counts run from 10 to 30 in
+// steps of 4, capped by $BLOCH_BENCH_MAX_QUBITS (default 24, a 256 MiB state)
+// so the suite fits on an ordinary machine; 30 qubits need 16 GiB.
+//
+// Each kernel reports amplitudes/s and bytes_per_second, the latter from the
+// minimum memory traffic of the kernel, in bytes per amplitude of the state:
+//   single-qubit gates  32  every amplitude read and written once
+//   cx                  16  the half with the control bit set is swapped
+//   measure             32  probability pass over half, then collapse pass
+//   allocateQubit       24  old half copied, new half zero-filled
+
+namespace {
+    constexpr int kMinQubits = 10;
+    constexpr int kMaxQubits = 30;
+    constexpr int kQubitStep = 4;
+    constexpr int kAmplitudeBytes = sizeof(std::complex<double>);
+
+    int maxQubits() {
+        static const int limit = [] {
+            const char* env = std::getenv("BLOCH_BENCH_MAX_QUBITS");
+            int n = env ? std::atoi(env) : 24;
+            return n < kMinQubits ? kMinQubits : (n > kMaxQubits ? kMaxQubits : n);
+        }();
+        return limit;
+    }
+
+    // {qubits} for every benchmarked size
+    void qubitCounts(benchmark::internal::Benchmark* b) {
+        for (int n = kMinQubits; n <= maxQubits(); n += kQubitStep)
+            b->Arg(n);
+    }
+
+    // {qubits, target} with the target at the lowest, middle and highest bit,
+    // covering unit-stride, mid-stride and half-state-stride access
+    void qubitsAndTargets(benchmark::internal::Benchmark* b) {
+        for (int n = kMinQubits; n <= maxQubits(); n += kQubitStep)
+            for (int target : {0, n / 2, n - 1})
+                b->Args({n, target});
+    }
+
+    // A simulator with `n` qubits in uniform superposition
+    QasmSimulator prepared(int n) {
+        QasmSimulator sim(false);
+        for (int q = 0; q < n; ++q) {
+            sim.allocateQubit();
+            sim.h(q);
+        }
+        return sim;
+    }
+
+    void reportTraffic(benchmark::State& state, size_t amplitudes, int bytesPerAmplitude) {
+        double processed = static_cast<double>(state.iterations()) * amplitudes;
+        state.counters["amplitudes/s"] =
+            benchmark::Counter(processed, benchmark::Counter::kIsRate);
+        state.SetBytesProcessed(static_cast<int64_t>(processed) * bytesPerAmplitude);
+    }
+}
+
+static void BM_SingleQubitGate(benchmark::State& state, void (QasmSimulator::*gate)(int)) {
+    const int n = static_cast<int>(state.range(0));
+    const int target = static_cast<int>(state.range(1));
+    QasmSimulator sim = prepared(n);
+    for (auto _ : state) {
+        (sim.*gate)(target);
+        benchmark::ClobberMemory();
+    }
+    reportTraffic(state, sim.stateSize(), 2 * kAmplitudeBytes);
+}
+BENCHMARK_CAPTURE(BM_SingleQubitGate, h, &QasmSimulator::h)->Apply(qubitsAndTargets);
+BENCHMARK_CAPTURE(BM_SingleQubitGate, x, &QasmSimulator::x)->Apply(qubitsAndTargets);
+BENCHMARK_CAPTURE(BM_SingleQubitGate, y, &QasmSimulator::y)->Apply(qubitsAndTargets);
+BENCHMARK_CAPTURE(BM_SingleQubitGate, z, &QasmSimulator::z)->Apply(qubitsAndTargets);
+
+static void BM_RotationGate(benchmark::State& state, void (QasmSimulator::*gate)(int, double)) {
+    const int n = static_cast<int>(state.range(0));
+    const int target = static_cast<int>(state.range(1));
+    QasmSimulator sim = prepared(n);
+    for (auto _ : state) {
+        (sim.*gate)(target, 0.3);
+        benchmark::ClobberMemory();
+    }
+    reportTraffic(state, sim.stateSize(), 2 * kAmplitudeBytes);
+}
+BENCHMARK_CAPTURE(BM_RotationGate, rx, &QasmSimulator::rx)->Apply(qubitsAndTargets);
+BENCHMARK_CAPTURE(BM_RotationGate, ry, &QasmSimulator::ry)->Apply(qubitsAndTargets);
+BENCHMARK_CAPTURE(BM_RotationGate, rz, &QasmSimulator::rz)->Apply(qubitsAndTargets);
+
+// The control is the qubit above the target, wrapping to 0 for the top qubit
+static void BM_ControlledNot(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int target = static_cast<int>(state.range(1));
+    QasmSimulator sim = prepared(n);
+    for (auto _ : state) {
+        sim.cx((target + 1) % n, target);
+        benchmark::ClobberMemory();
+    }
+    reportTraffic(state, sim.stateSize(), kAmplitudeBytes);
+}
+BENCHMARK(BM_ControlledNot)->Apply(qubitsAndTargets);
+
+// After the first iteration the target is collapsed, which leaves the cost of
+// both passes unchanged
+static void BM_Measure(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int target = static_cast<int>(state.range(1));
+    QasmSimulator sim = prepared(n);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(sim.measure(target));
+    reportTraffic(state, sim.stateSize(), 2 * kAmplitudeBytes);
+}
+BENCHMARK(BM_Measure)->Apply(qubitsAndTargets);
+
+// Growing an (n - 1)-qubit state to n qubits
+static void BM_AllocateQubit(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        QasmSimulator sim = prepared(n - 1);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(sim.allocateQubit());
+        state.PauseTiming();
+        sim = QasmSimulator(false);
+        state.ResumeTiming();
+    }
+    reportTraffic(state, size_t{1} << n, kAmplitudeBytes * 3 / 2);
+}
+BENCHMARK(BM_AllocateQubit)->Apply(qubitCounts);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+
+namespace bloch::bench {
+
+    // Repeats a representative function, with comments, literals and both
+    // classical and quantum statements, until the source reaches `bytes`
+    inline std::string generateSource(size_t bytes) {
+        std::string src;
+        src.reserve(bytes + 512);
+        for (int i = 0; src.size() < bytes; ++i) {
+            std::string n = std::to_string(i);
+            src += "// helper " + n + "\n@quantum\nfunction helper_" + n +
+                   "(qubit target, int count) -> bit {\n"
+                   "    float angle = 0.25f;\n"
+                   "    for (int i = 0; i < count; i = i + 1) {\n"
+                   "        rx(target, angle * i);\n"
+                   "        if (i % 2 == 0) { h(target); } else { x(target); }\n"
+                   "    }\n"
+                   "    return measure target;  // collapse\n"
+                   "}\n\n";
+        }
+        return src;
+    }
+
+    // Mostly keywords and identifiers, including near misses such as
+    // `integer` and `format`, until the source reaches `bytes`
+    inline std::string generateIdentifierSource(size_t bytes) {
+        static const char* words[] = {"int",     "integer", "float",  "format", "return",
+                                      "result",  "if",      "index",  "for",    "final",
+                                      "measure", "members", "qubit",  "quota",  "echo",
+                                      "else",    "element", "public", "private", "counter"};
+        std::string src;
+        src.reserve(bytes + 64);
+        for (size_t i = 0; src.size() < bytes; ++i) {
+            src += words[i % 20];
+            src += (i % 20 == 19) ? '\n' : ' ';
+        }
+        return src;
+    }
+
+    // Deeply indented statements separated by blank lines and comment
+    // banners, as emitted by code generators, until the source reaches `bytes`
+    inline std::string generateIndentedSource(size_t bytes) {
+        const std::string indent(48, ' ');
+        std::string src;
+        src.reserve(bytes + 512);
+        for (int i = 0; src.size() < bytes; ++i) {
+            src += "//" + std::string(70, '-') + "\n// block " + std::to_string(i) + "\n\n";
+            src += indent + "int v = " + std::to_string(i) + ";\n\n";
+            src += indent + "\t\tv = v + 1;  // step\n\n\n";
+        }
+        return src;
+    }
+
+    // `functions` classical functions with loops and branches, all called
+    // from main, so that executing the program walks every node
+    inline std::string generateClassicalProgram(int functions) {
+        std::string src;
+        for (int i = 0; i < functions; ++i) {
+            std::string n = std::to_string(i);
+            src += "function f" + n +
+                   "(int count) -> int {\n"
+                   "    int total = " + n + ";\n"
+                   "    for (int i = 0; i < count; i = i + 1) {\n"
+                   "        if (i % 3 == 0) { total = total + i * 2; }\n"
+                   "        else { total = total - 1; }\n"
+                   "    }\n"
+                   "    return total;\n"
+                   "}\n";
+        }
+        src += "function main() -> void {\n    int sum = 0;\n";
+        for (int i = 0; i < functions; ++i)
+            src += "    sum = sum + f" + std::to_string(i) + "(8);\n";
+        src += "}\n";
+        return src;
+    }
+
+}
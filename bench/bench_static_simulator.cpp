@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include <utility>
+#include "bloch/runtime/qasm_simulator.hpp"
+#include "bloch/runtime/static_state_vector.hpp"
+
+using namespace bloch;
+
+// One layer of a GHZ-style circuit: h on every qubit, then a cx ladder. Both
+// simulators run the same gates so the difference is the cost of runtime strides.
+static void BM_QasmSimulatorLayer(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    QasmSimulator sim(false);
+    for (int q = 0; q < n; ++q) sim.allocateQubit();
+    for (auto _ : state) {
+        for (int q = 0; q < n; ++q) sim.h(q);
+        for (int q = 0; q + 1 < n; ++q) sim.cx(q, q + 1);
+    }
+    state.SetItemsProcessed(state.iterations() * (2 * n - 1));
+    state.SetLabel("gates");
+}
+BENCHMARK(BM_QasmSimulatorLayer)->Arg(10)->Arg(16)->Arg(20);
+
+template <int N, size_t... Q>
+static void staticLayer(StaticStateVector<N>& sv, std::index_sequence<Q...>) {
+    (sv.template h<Q>(), ...);
+    (sv.template cx<Q, Q + 1>(), ...);
+}
+
+template <int N>
+static void BM_StaticStateVectorLayer(benchmark::State& state) {
+    StaticStateVector<N> sv;
+    for (auto _ : state) {
+        staticLayer<N>(sv, std::make_index_sequence<N - 1>{});
+        sv.template h<N - 1>();
+    }
+    state.SetItemsProcessed(state.iterations() * (2 * N - 1));
+    state.SetLabel("gates");
+}
+BENCHMARK_TEMPLATE(BM_StaticStateVectorLayer, 10);
+BENCHMARK_TEMPLATE(BM_StaticStateVectorLayer, 16);
+BENCHMARK_TEMPLATE(BM_StaticStateVectorLayer, 20);
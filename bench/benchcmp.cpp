@@ -0,0 +1,122 @@
+// Compares two benchmark result files and fails on significant regressions.
+//
+//   bloch-benchcmp [--threshold PCT] [--confidence C] [--filter TEXT] <baseline> <new>
+//
+// Inputs are bloch-bench JSON (from bloch_corpus_run) or Google Benchmark JSON
+// (bloch_bench --benchmark_format=json --benchmark_repetitions=N). A benchmark
+// regresses when it is slower by more than the threshold (default 5%) and the
+// difference is significant at the confidence level (default 0.95). Exits 1
+// when any benchmark regresses and 2 on usage or input errors.
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "bloch/profiling/bench_results.hpp"
+
+namespace {
+    bloch::BenchmarkResults load(const std::string& path) {
+        std::ifstream in(path);
+        if (!in)
+            throw std::runtime_error("Failed to open " + path);
+        std::stringstream text;
+        text << in.rdbuf();
+        return bloch::BenchmarkResults::parse(text.str());
+    }
+
+    std::string percent(double fraction) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%+.1f%%", fraction * 100);
+        return buffer;
+    }
+}
+
+int main(int argc, char** argv) {
+    double threshold = 5;
+    double confidence = 0.95;
+    std::string filter;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threshold" && i + 1 < argc)
+            threshold = std::atof(argv[++i]);
+        else if (arg == "--confidence" && i + 1 < argc)
+            confidence = std::atof(argv[++i]);
+        else if (arg == "--filter" && i + 1 < argc)
+            filter = argv[++i];
+        else
+            files.push_back(arg);
+    }
+    if (files.size() != 2 || confidence <= 0 || confidence >= 1) {
+        std::cerr << "Usage: bloch-benchcmp [--threshold PCT] [--confidence C] [--filter TEXT] "
+                     "<baseline.json> <new.json>\n";
+        return 2;
+    }
+
+    bloch::BenchmarkResults base, current;
+    try {
+        base = load(files[0]);
+        current = load(files[1]);
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 2;
+    }
+
+    auto comparisons = bloch::compareBenchmarks(base, current, confidence);
+    comparisons.erase(std::remove_if(comparisons.begin(), comparisons.end(),
+                                     [&](const auto& c) {
+                                         return c.name.find(filter) == std::string::npos;
+                                     }),
+                      comparisons.end());
+    size_t width = 9;
+    for (const auto& c : comparisons)
+        width = std::max(width, c.name.size());
+
+    int ciPercent = static_cast<int>(confidence * 100 + 0.5);
+    std::printf("%-*s %6s %12s %12s %8s %20s %7s\n", static_cast<int>(width), "benchmark", "unit",
+                base.label.empty() ? "baseline" : base.label.substr(0, 12).c_str(),
+                current.label.empty() ? "new" : current.label.substr(0, 12).c_str(), "change",
+                (std::to_string(ciPercent) + "% interval").c_str(), "p");
+    int regressions = 0;
+    int untestable = 0;
+    for (const auto& c : comparisons) {
+        std::string interval = "n/a";
+        std::string p = "n/a";
+        const char* verdict = "";
+        if (c.testable) {
+            interval = "[" + percent(c.ciLow) + ", " + percent(c.ciHigh) + "]";
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "%.3f", c.pValue);
+            p = buffer;
+            bool significant = c.pValue < 1 - confidence;
+            if (significant && c.change * 100 > threshold) {
+                verdict = "  REGRESSION";
+                ++regressions;
+            } else if (significant && -c.change * 100 > threshold) {
+                verdict = "  improved";
+            }
+        } else {
+            ++untestable;
+        }
+        std::printf("%-*s %6s %12.4g %12.4g %8s %20s %7s%s\n", static_cast<int>(width),
+                    c.name.c_str(), c.unit.c_str(), c.baseMean, c.newMean,
+                    percent(c.change).c_str(), interval.c_str(), p.c_str(), verdict);
+    }
+    for (const auto& series : base.benchmarks)
+        if (!current.find(series.name) && series.name.find(filter) != std::string::npos)
+            std::printf("only in baseline: %s\n", series.name.c_str());
+    for (const auto& series : current.benchmarks)
+        if (!base.find(series.name) && series.name.find(filter) != std::string::npos)
+            std::printf("only in new: %s\n", series.name.c_str());
+
+    if (untestable)
+        std::printf("%d benchmark(s) have fewer than two samples on a side and were not tested\n",
+                    untestable);
+    if (regressions) {
+        std::printf("%d benchmark(s) regressed by more than %g%%\n", regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,243 @@
+// Generates the scalable Bloch programs of the end-to-end benchmark corpus.
+//
+//   bloch_corpus_gen <dir>                        write the standard corpus to <dir>
+//   bloch_corpus_gen <kind> <size> [depth] [seed] print one program
+//
+// Kinds: ghz (qubits), qft (qubits), random (qubits, layers), rus (rounds) and
+// classical (loop iterations). Output is deterministic for a given seed.
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    // Portable generator, unlike the std distributions
+    class SplitMix64 {
+       public:
+        explicit SplitMix64(uint64_t seed) : m_state(seed) {}
+        uint64_t next() {
+            uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+        int below(int n) { return static_cast<int>(next() % static_cast<uint64_t>(n)); }
+
+       private:
+        uint64_t m_state;
+    };
+
+    // Bloch float literals are fixed-point with an `f` suffix
+    std::string literal(double value, int precision = 12) {
+        std::ostringstream out;
+        out << std::fixed;
+        out.precision(precision);
+        out << value << "f";
+        return out.str();
+    }
+
+    void declareQubits(std::ostream& out, int n) {
+        for (int q = 0; q < n; ++q)
+            out << "    qubit q" << q << ";\n";
+    }
+
+    // Sums the measured bits so the program prints one number
+    void measureAll(std::ostream& out, int n) {
+        out << "    int ones = 0;\n";
+        for (int q = 0; q < n; ++q)
+            out << "    bit r" << q << " = measure q" << q << ";\n"
+                << "    ones = ones + r" << q << ";\n";
+        out << "    echo(ones);\n";
+    }
+
+    std::string ghz(int n) {
+        std::ostringstream out;
+        out << "// " << n << "-qubit GHZ state\n"
+            << "function main() -> void {\n";
+        declareQubits(out, n);
+        out << "    h(q0);\n";
+        for (int q = 0; q + 1 < n; ++q)
+            out << "    cx(q" << q << ", q" << q + 1 << ");\n";
+        measureAll(out, n);
+        out << "}\n";
+        return out.str();
+    }
+
+    // Controlled phases are decomposed into rz and cx, the available gates
+    std::string qft(int n) {
+        std::ostringstream out;
+        out << "// " << n << "-qubit quantum Fourier transform of a basis state\n"
+            << "@quantum\n"
+            << "function cphase(qubit c, qubit t, float theta) -> void {\n"
+            << "    rz(c, theta / 2);\n"
+            << "    cx(c, t);\n"
+            << "    rz(t, -theta / 2);\n"
+            << "    cx(c, t);\n"
+            << "    rz(t, theta / 2);\n"
+            << "}\n\n"
+            << "function main() -> void {\n";
+        declareQubits(out, n);
+        for (int q = 0; q < n; q += 2)
+            out << "    x(q" << q << ");\n";
+        for (int j = 0; j < n; ++j) {
+            out << "    h(q" << j << ");\n";
+            for (int k = j + 1; k < n; ++k)
+                out << "    cphase(q" << k << ", q" << j << ", "
+                    << literal(std::ldexp(3.14159265358979323846, j - k)) << ");\n";
+        }
+        measureAll(out, n);
+        out << "}\n";
+        return out.str();
+    }
+
+    // Each layer applies a random single-qubit gate to every qubit, then cx on
+    // random disjoint pairs
+    std::string randomCircuit(int n, int depth, uint64_t seed) {
+        static const char* gates[] = {"h", "x", "y", "z", "rx", "ry", "rz"};
+        SplitMix64 rng(seed);
+        std::ostringstream out;
+        out << "// " << n << "-qubit random circuit, " << depth << " layers, seed " << seed
+            << "\n"
+            << "function main() -> void {\n";
+        declareQubits(out, n);
+        std::vector<int> order(n);
+        for (int layer = 0; layer < depth; ++layer) {
+            for (int q = 0; q < n; ++q) {
+                int g = rng.below(7);
+                out << "    " << gates[g] << "(q" << q;
+                if (g >= 4)
+                    out << ", " << literal((rng.next() % 6284) / 1000.0, 3);
+                out << ");\n";
+            }
+            for (int q = 0; q < n; ++q)
+                order[q] = q;
+            for (int q = n - 1; q > 0; --q)
+                std::swap(order[q], order[rng.below(q + 1)]);
+            for (int p = 0; p + 1 < n; p += 2)
+                out << "    cx(q" << order[p] << ", q" << order[p + 1] << ");\n";
+        }
+        measureAll(out, n);
+        out << "}\n";
+        return out.str();
+    }
+
+    // Repeat-until-success: retries an entangle-and-measure step until it
+    // succeeds, restoring both qubits to |0> by hand after every attempt
+    std::string repeatUntilSuccess(int rounds) {
+        std::ostringstream out;
+        out << "// repeat-until-success, " << rounds << " rounds\n"
+            << "@quantum\n"
+            << "function attempt(qubit a, qubit b) -> bit {\n"
+            << "    h(a);\n"
+            << "    cx(a, b);\n"
+            << "    bit r = measure a;\n"
+            << "    bit s = measure b;\n"
+            << "    if (r == 1) {\n"
+            << "        x(a);\n"
+            << "    }\n"
+            << "    if (s == 1) {\n"
+            << "        x(b);\n"
+            << "    }\n"
+            << "    return r;\n"
+            << "}\n\n"
+            << "function main() -> void {\n"
+            << "    qubit a;\n"
+            << "    qubit b;\n"
+            << "    int attempts = 0;\n"
+            << "    for (int round = 0; round < " << rounds << "; round = round + 1) {\n"
+            << "        bit done = 0;\n"
+            << "        for (int i = 0; done == 0; i = i + 1) {\n"
+            << "            done = attempt(a, b);\n"
+            << "            attempts = attempts + 1;\n"
+            << "        }\n"
+            << "    }\n"
+            << "    echo(attempts);\n"
+            << "}\n";
+        return out.str();
+    }
+
+    std::string classical(int iterations) {
+        std::ostringstream out;
+        out << "// classical loop, " << iterations << " iterations\n"
+            << "function mix(int a, int b) -> int {\n"
+            << "    return (a * 31 + b) % 1000003;\n"
+            << "}\n\n"
+            << "function main() -> void {\n"
+            << "    int total = 0;\n"
+            << "    for (int i = 0; i < " << iterations << "; i = i + 1) {\n"
+            << "        total = mix(total, i);\n"
+            << "        if (total % 2 == 0) {\n"
+            << "            total = total + 1;\n"
+            << "        }\n"
+            << "    }\n"
+            << "    echo(total);\n"
+            << "}\n";
+        return out.str();
+    }
+
+    bool generate(const std::string& kind, int size, int depth, uint64_t seed, std::string& out) {
+        if (kind == "ghz")
+            out = ghz(size);
+        else if (kind == "qft")
+            out = qft(size);
+        else if (kind == "random")
+            out = randomCircuit(size, depth, seed);
+        else if (kind == "rus")
+            out = repeatUntilSuccess(size);
+        else if (kind == "classical")
+            out = classical(size);
+        else
+            return false;
+        return true;
+    }
+
+    struct CorpusEntry {
+        const char* kind;
+        int size;
+        int depth;
+    };
+
+    // Sized so the largest of each kind runs in seconds on the reference
+    // interpreter; the qubit counts stay within a 16 MiB state vector
+    const CorpusEntry kCorpus[] = {
+        {"ghz", 8, 0},           {"ghz", 16, 0},         {"ghz", 20, 0},
+        {"qft", 8, 0},           {"qft", 12, 0},         {"qft", 16, 0},
+        {"random", 12, 20},      {"random", 16, 40},     {"rus", 100, 0},
+        {"rus", 1000, 0},        {"classical", 10000, 0}, {"classical", 100000, 0},
+        {"classical", 1000000, 0},
+    };
+    constexpr uint64_t kCorpusSeed = 2025;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2) {
+        std::filesystem::path dir = argv[1];
+        std::filesystem::create_directories(dir);
+        for (const auto& entry : kCorpus) {
+            std::string name = std::string(entry.kind) + "_" + std::to_string(entry.size);
+            if (entry.depth)
+                name += "_d" + std::to_string(entry.depth);
+            std::string program;
+            generate(entry.kind, entry.size, entry.depth, kCorpusSeed, program);
+            std::ofstream(dir / (name + ".bloch")) << program;
+        }
+        return 0;
+    }
+    if (argc >= 3) {
+        std::string program;
+        int depth = argc > 3 ? std::atoi(argv[3]) : 10;
+        uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : kCorpusSeed;
+        if (generate(argv[1], std::atoi(argv[2]), depth, seed, program)) {
+            std::cout << program;
+            return 0;
+        }
+    }
+    std::cerr << "Usage: bloch_corpus_gen <dir>\n"
+                 "       bloch_corpus_gen ghz|qft|random|rus|classical <size> [depth] [seed]\n";
+    return 1;
+}
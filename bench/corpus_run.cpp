@@ -0,0 +1,132 @@
+// Runs every program of a benchmark corpus through the full `bloch` pipeline
+// and records per-phase time and peak memory in the bloch-bench JSON format
+// read by bloch-benchcmp.
+//
+//   bloch_corpus_run [--bloch <path>] [--repetitions N] [--shots N] [--label text]
+//                    [--output file] <corpus-dir>
+//
+// Each program yields the series <name>/<phase> and <name>/total in ms and
+// <name>/peak_rss in kB, one sample per repetition. Every repetition is a
+// separate process, so peak RSS is per program.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include "bloch/profiling/bench_results.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    struct Run {
+        int status = 0;
+        double wallMs = 0;
+        // {"phases": [...]} as printed by --time-phases=json
+        std::string phases;
+    };
+
+    std::string quote(const std::string& s) { return "\"" + s + "\""; }
+
+    Run runProgram(const std::string& bloch, const fs::path& program, int shots) {
+        // stderr carries the phase report; the program's own output is discarded
+        std::string command = quote(bloch) + " --time-phases=json --shots " +
+                              std::to_string(shots) + " " + quote(program.string()) +
+                              " 2>&1 1>/dev/null";
+        Run run;
+        auto start = std::chrono::steady_clock::now();
+        FILE* pipe = popen(command.c_str(), "r");
+        if (!pipe) {
+            run.status = -1;
+            return run;
+        }
+        std::string output;
+        char buffer[4096];
+        while (size_t n = fread(buffer, 1, sizeof(buffer), pipe))
+            output.append(buffer, n);
+        int status = pclose(pipe);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        run.wallMs = std::chrono::duration<double, std::milli>(elapsed).count();
+        run.status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        size_t report = output.rfind("{\"phases\"");
+        if (report != std::string::npos)
+            run.phases = output.substr(report);
+        else if (run.status == 0)
+            run.status = -1;
+        return run;
+    }
+
+    void record(bloch::BenchmarkResults& results, const std::string& name, const Run& run) {
+        static const std::regex phase(R"re(\{"name": "([^"]+)", "wall_ms": ([0-9.]+), )re"
+                                      R"re("cpu_ms": [0-9.]+, "peak_rss_kb": ([0-9]+))re");
+        long peakRss = 0;
+        for (std::sregex_iterator it(run.phases.begin(), run.phases.end(), phase), end; it != end;
+             ++it) {
+            results.add(name + "/" + (*it)[1].str(), "ms", std::stod((*it)[2].str()));
+            peakRss = std::max(peakRss, std::stol((*it)[3].str()));
+        }
+        results.add(name + "/total", "ms", run.wallMs);
+        results.add(name + "/peak_rss", "kB", static_cast<double>(peakRss));
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string bloch = BLOCH_EXECUTABLE;
+    std::string output;
+    int repetitions = 5;
+    int shots = 1;
+    bloch::BenchmarkResults results;
+    fs::path corpus;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bloch" && i + 1 < argc)
+            bloch = argv[++i];
+        else if (arg == "--repetitions" && i + 1 < argc)
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--shots" && i + 1 < argc)
+            shots = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--label" && i + 1 < argc)
+            results.label = argv[++i];
+        else if (arg == "--output" && i + 1 < argc)
+            output = argv[++i];
+        else
+            corpus = arg;
+    }
+    if (corpus.empty() || !fs::is_directory(corpus)) {
+        std::cerr << "Usage: bloch_corpus_run [--bloch <path>] [--repetitions N] [--shots N] "
+                     "[--label text] [--output file] <corpus-dir>\n";
+        return 1;
+    }
+
+    std::vector<fs::path> programs;
+    for (const auto& entry : fs::directory_iterator(corpus))
+        if (entry.path().extension() == ".bloch")
+            programs.push_back(entry.path());
+    std::sort(programs.begin(), programs.end());
+
+    bool failed = false;
+    for (const auto& program : programs) {
+        std::string name = program.stem().string();
+        std::cerr << name << "\n";
+        for (int r = 0; r < repetitions; ++r) {
+            Run run = runProgram(bloch, program, shots);
+            if (run.status != 0) {
+                std::cerr << name << " failed with status " << run.status << "\n";
+                failed = true;
+                break;
+            }
+            record(results, name, run);
+        }
+    }
+
+    if (output.empty())
+        std::cout << results.json();
+    else
+        std::ofstream(output) << results.json();
+    return failed ? 1 : 0;
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <charconv>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
+#include "../lexer/symbol.hpp"
+#include "ast_arena.hpp"
 
 namespace bloch {
 
@@ -14,6 +18,10 @@ namespace bloch {
         int column = 0;
         virtual ~ASTNode() = default;
         virtual void accept(ASTVisitor& visitor) = 0;
+
+        // Placed in the active AstArena, if any
+        static void* operator new(size_t size);
+        static void operator delete(void* node) noexcept;
     };
 
     struct Statement : public ASTNode {};
@@ -35,7 +43,7 @@ namespace bloch {
 
     // Variable Declaration
     struct VariableDeclaration : public Statement {
-        std::string name;
+        Symbol name;
         std::string access;
         std::unique_ptr<Type> varType;
         std::unique_ptr<Expression> initializer;
@@ -117,20 +125,73 @@ namespace bloch {
 
     // Assignment
     struct AssignmentStatement : public Statement {
-        std::string name;
+        Symbol name;
         std::unique_ptr<Expression> value;
 
         AssignmentStatement() = default;
         void accept(ASTVisitor& visitor) override;
     };
 
+    // Operators
+    enum class BinaryOp {
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Modulo,
+        Greater,
+        Less,
+        GreaterEqual,
+        LessEqual,
+        Equal,
+        NotEqual
+    };
+
+    enum class UnaryOp { Negate };
+
+    inline const char* toString(BinaryOp op) {
+        switch (op) {
+            case BinaryOp::Add:
+                return "+";
+            case BinaryOp::Subtract:
+                return "-";
+            case BinaryOp::Multiply:
+                return "*";
+            case BinaryOp::Divide:
+                return "/";
+            case BinaryOp::Modulo:
+                return "%";
+            case BinaryOp::Greater:
+                return ">";
+            case BinaryOp::Less:
+                return "<";
+            case BinaryOp::GreaterEqual:
+                return ">=";
+            case BinaryOp::LessEqual:
+                return "<=";
+            case BinaryOp::Equal:
+                return "==";
+            case BinaryOp::NotEqual:
+                return "!=";
+        }
+        return "?";
+    }
+
+    inline const char* toString(UnaryOp op) {
+        switch (op) {
+            case UnaryOp::Negate:
+                return "-";
+        }
+        return "?";
+    }
+
     // Binary Expression
     struct BinaryExpression : public Expression {
-        std::string op;
+        BinaryOp op;
         std::unique_ptr<Expression> left;
         std::unique_ptr<Expression> right;
 
-        BinaryExpression(const std::string& op, std::unique_ptr<Expression> left,
+        BinaryExpression(BinaryOp op, std::unique_ptr<Expression> left,
                          std::unique_ptr<Expression> right)
             : op(op), left(std::move(left)), right(std::move(right)) {}
         void accept(ASTVisitor& visitor) override;
@@ -138,29 +199,72 @@ namespace bloch {
 
     // Unary Expression
     struct UnaryExpression : public Expression {
-        std::string op;
+        UnaryOp op;
         std::unique_ptr<Expression> right;
 
-        UnaryExpression(const std::string& op, std::unique_ptr<Expression> right)
+        UnaryExpression(UnaryOp op, std::unique_ptr<Expression> right)
             : op(op), right(std::move(right)) {}
         void accept(ASTVisitor& visitor) override;
     };
 
     // Literal Expression
+    // The source text is kept for diagnostics and code generation, while numeric
+    // values are decoded once on construction so later stages never re-parse them.
+    enum class LiteralKind { Int, Float, Bit, Char, String };
+
     struct LiteralExpression : public Expression {
         std::string value;
         std::string literalType;
-
-        LiteralExpression(const std::string& value, const std::string& type)
-            : value(value), literalType(type) {}
-        void accept(ASTVisitor& visitor) override;
+        LiteralKind kind = LiteralKind::String;
+        int intValue = 0;
+        double floatValue = 0.0;
+
+        // The parser rejects numeric literals that do not fit their type, so
+        // decoding never fails
+        LiteralExpression(const std::string& value, const std::string& type, int line = 0,
+                          int column = 0)
+            : value(value), literalType(type) {
+            this->line = line;
+            this->column = column;
+            decode();
+        }
+        void accept(ASTVisitor& visitor) override;
+
+       private:
+        void decode() {
+            const char* first = value.data();
+            const char* last = first + value.size();
+            if (literalType == "int" || literalType == "bit") {
+                kind = literalType == "int" ? LiteralKind::Int : LiteralKind::Bit;
+                std::from_chars(first, last, intValue);
+                floatValue = intValue;
+            } else if (literalType == "float") {
+                kind = LiteralKind::Float;
+                if (!value.empty() && value.back() == 'f')
+                    --last;
+                std::from_chars(first, last, floatValue);
+                // floats beyond the range of int saturate rather than overflow
+                if (floatValue >= static_cast<double>(std::numeric_limits<int>::max()))
+                    intValue = std::numeric_limits<int>::max();
+                else if (floatValue <= static_cast<double>(std::numeric_limits<int>::min()))
+                    intValue = std::numeric_limits<int>::min();
+                else
+                    intValue = static_cast<int>(floatValue);
+            } else if (literalType == "char") {
+                kind = LiteralKind::Char;
+                if (value.size() >= 3)
+                    intValue = static_cast<unsigned char>(value[1]);
+            } else {
+                kind = LiteralKind::String;
+            }
+        }
     };
 
     // Variable Expression
     struct VariableExpression : public Expression {
-        std::string name;
+        Symbol name;
 
-        VariableExpression(const std::string& name) : name(name) {}
+        VariableExpression(Symbol name) : name(name) {}
         void accept(ASTVisitor& visitor) override;
     };
 
@@ -202,11 +306,11 @@ namespace bloch {
 
     // Assignment Expression
     struct AssignmentExpression : public Expression {
-        std::string name;
+        Symbol name;
         std::unique_ptr<Expression> value;
 
-        AssignmentExpression(std::string name, std::unique_ptr<Expression> value)
-            : name(std::move(name)), value(std::move(value)) {}
+        AssignmentExpression(Symbol name, std::unique_ptr<Expression> value)
+            : name(name), value(std::move(value)) {}
         void accept(ASTVisitor& visitor) override;
     };
 
@@ -267,7 +371,7 @@ namespace bloch {
 
     // Parameter
     struct Parameter : public ASTNode {
-        std::string name;
+        Symbol name;
         std::unique_ptr<Type> type;
 
         Parameter() = default;
@@ -287,7 +391,7 @@ namespace bloch {
 
     // Function Declaration
     struct FunctionDeclaration : public ASTNode {
-        std::string name;
+        Symbol name;
         std::vector<std::unique_ptr<Parameter>> params;
         std::unique_ptr<Type> returnType;
         std::unique_ptr<BlockStatement> body;
@@ -311,6 +415,8 @@ namespace bloch {
 
     // Program
     struct Program : public ASTNode {
+        // Declared first so that it is destroyed after the nodes it holds
+        std::unique_ptr<AstArena> arena = std::make_unique<AstArena>();
         std::vector<std::unique_ptr<ImportStatement>> imports;
         std::vector<std::unique_ptr<FunctionDeclaration>> functions;
         std::vector<std::unique_ptr<ClassDeclaration>> classes;
@@ -0,0 +1,53 @@
+#include "ast_arena.hpp"
+#include <algorithm>
+#include <new>
+#include "ast.hpp"
+
+namespace bloch {
+
+    namespace {
+        thread_local AstArena* t_current = nullptr;
+
+        constexpr size_t kAlign = alignof(std::max_align_t);
+        // Each node is preceded by the arena that owns it, or null for the heap
+        constexpr size_t kHeader = kAlign;
+
+        constexpr size_t alignUp(size_t bytes) { return (bytes + kAlign - 1) & ~(kAlign - 1); }
+    }
+
+    void* AstArena::allocate(size_t bytes) {
+        bytes = alignUp(bytes);
+        if (static_cast<size_t>(m_end - m_next) < bytes) {
+            size_t size = std::max(kChunkBytes, bytes);
+            m_chunks.push_back(std::make_unique<std::byte[]>(size));
+            m_next = m_chunks.back().get();
+            m_end = m_next + size;
+        }
+        void* result = m_next;
+        m_next += bytes;
+        m_used += bytes;
+        return result;
+    }
+
+    AstArena::Scope::Scope(AstArena* arena) : m_previous(t_current) { t_current = arena; }
+
+    AstArena::Scope::~Scope() { t_current = m_previous; }
+
+    AstArena* AstArena::current() { return t_current; }
+
+    void* ASTNode::operator new(size_t size) {
+        AstArena* arena = t_current;
+        void* block = arena ? arena->allocate(kHeader + size) : ::operator new(kHeader + size);
+        *static_cast<AstArena**>(block) = arena;
+        return static_cast<std::byte*>(block) + kHeader;
+    }
+
+    void ASTNode::operator delete(void* node) noexcept {
+        if (!node)
+            return;
+        void* block = static_cast<std::byte*>(node) - kHeader;
+        if (!*static_cast<AstArena**>(block))
+            ::operator delete(block);
+    }
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace bloch {
+
+    // Bump allocator for AST nodes. A Program owns one, and nodes created while
+    // an AstArena::Scope is active are placed in it contiguously, in creation
+    // order. Deleting such a node runs its destructor but leaves the memory to
+    // be released in bulk with the arena, so nodes must not outlive their
+    // Program. Nodes created outside a scope come from the heap as usual.
+    class AstArena {
+       public:
+        static constexpr size_t kChunkBytes = 64 * 1024;
+
+        AstArena() = default;
+        AstArena(const AstArena&) = delete;
+        AstArena& operator=(const AstArena&) = delete;
+
+        // Returns `bytes` of storage aligned for any node
+        void* allocate(size_t bytes);
+        size_t bytesUsed() const { return m_used; }
+        size_t chunks() const { return m_chunks.size(); }
+
+        // Routes node allocations on this thread to `arena` for its lifetime
+        class Scope {
+           public:
+            explicit Scope(AstArena* arena);
+            ~Scope();
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+           private:
+            AstArena* m_previous;
+        };
+
+        static AstArena* current();
+
+       private:
+        std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+        std::byte* m_next = nullptr;
+        std::byte* m_end = nullptr;
+        size_t m_used = 0;
+    };
+
+}
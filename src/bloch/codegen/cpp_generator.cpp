@@ -1,9 +1,25 @@
 #include "cpp_generator.hpp"
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 namespace bloch {
 
+    namespace {
+        const std::unordered_map<const Expression*, int> kNoMeasurements;
+
+        // Name of the simulator instance in generated native programs
+        constexpr const char* kSim = "bloch_sim";
+    }
+
+    CppGenerator::CppGenerator(CppTarget target) : m_measure(kNoMeasurements), m_target(target) {}
+
+    CppGenerator::CppGenerator(const CppGeneratorOptions& options)
+        : m_measure(kNoMeasurements),
+          m_target(options.target),
+          m_specialiseQubits(options.specialiseQubits),
+          m_sharedLibrary(options.sharedLibrary) {}
+
     void CppGenerator::indent() { m_code.append(m_indent * 4, ' '); }
 
     std::string CppGenerator::cppType(Type* t) {
@@ -12,8 +28,8 @@ namespace bloch {
         if (auto prim = dynamic_cast<PrimitiveType*>(t)) {
             if (prim->name == "bit")
                 return "bool";
-            if (prim->name == "qubit")
-                return "/*qubit*/";  // should not appear in generated code
+            if (prim->name == "qubit")  // native qubits are simulator indices
+                return m_target == CppTarget::NativeSimulator ? "int" : "/*qubit*/";
             return prim->name;
         }
         if (dynamic_cast<VoidType*>(t))
@@ -21,15 +37,29 @@ namespace bloch {
         return "int";
     }
 
+    std::string CppGenerator::signature(FunctionDeclaration* fn) {
+        // the native driver owns `main`, so the program's entry point is renamed
+        bool entry = m_target == CppTarget::NativeSimulator && fn->name == "main";
+        std::string name = entry ? "bloch_main" : fn->name.str();
+        std::string sig = cppType(fn->returnType.get()) + " " + name;
+        std::string templateParams;
+        std::string params;
+        for (auto& param : fn->params) {
+            // specialised qubit parameters are template parameters
+            bool asTemplate = m_specialised && isQubit(param->type.get());
+            std::string& list = asTemplate ? templateParams : params;
+            if (!list.empty())
+                list += ", ";
+            list += cppType(param->type.get()) + " " + param->name;
+        }
+        if (!templateParams.empty())
+            sig = "template <" + templateParams + "> " + sig;
+        return sig + "(" + params + ")";
+    }
+
     void CppGenerator::genFunction(FunctionDeclaration* fn) {
         indent();
-        m_code += cppType(fn->returnType.get()) + " " + fn->name + "(";
-        for (size_t i = 0; i < fn->params.size(); ++i) {
-            if (i)
-                m_code += ", ";
-            m_code += cppType(fn->params[i]->type.get()) + " " + fn->params[i]->name;
-        }
-        m_code += ")\n";
+        m_code += signature(fn) + "\n";
         genStmt(fn->body.get());
         m_code += "\n";
     }
@@ -42,14 +72,30 @@ namespace bloch {
         } else if (auto var = dynamic_cast<VariableExpression*>(e)) {
             return var->name;
         } else if (auto bin = dynamic_cast<BinaryExpression*>(e)) {
-            return genExpr(bin->left.get()) + " " + bin->op + " " + genExpr(bin->right.get());
+            return genExpr(bin->left.get()) + " " + toString(bin->op) + " " +
+                   genExpr(bin->right.get());
         } else if (auto unary = dynamic_cast<UnaryExpression*>(e)) {
-            return unary->op + genExpr(unary->right.get());
+            return toString(unary->op) + genExpr(unary->right.get());
+        } else if (auto paren = dynamic_cast<ParenthesizedExpression*>(e)) {
+            return "(" + genExpr(paren->expression.get()) + ")";
         } else if (auto call = dynamic_cast<CallExpression*>(e)) {
             if (auto var = dynamic_cast<VariableExpression*>(call->callee.get())) {
-                const std::string& name = var->name;
-                if (builtInGates.count(name))
-                    return "";  // omit quantum builtins
+                Symbol name = var->name;
+                if (builtInGates.count(name)) {
+                    if (m_target == CppTarget::Classical)
+                        return "";  // omit quantum builtins
+                    std::vector<bool> qubitParams;
+                    for (ValueType type : builtInGates.at(name).paramTypes)
+                        qubitParams.push_back(type == ValueType::Qubit);
+                    return genCall(std::string(kSim) + "." + name, call, qubitParams);
+                }
+                auto fn = m_functions.find(name);
+                if (m_target == CppTarget::NativeSimulator && fn != m_functions.end()) {
+                    std::vector<bool> qubitParams;
+                    for (auto& param : fn->second->params)
+                        qubitParams.push_back(isQubit(param->type.get()));
+                    return genCall(name, call, qubitParams);
+                }
             }
             std::ostringstream oss;
             oss << genExpr(call->callee.get()) << "(";
@@ -65,6 +111,8 @@ namespace bloch {
             }
             return oss.str();
         } else if (auto meas = dynamic_cast<MeasureExpression*>(e)) {
+            if (m_target == CppTarget::NativeSimulator)
+                return genMeasure(meas->qubit.get());
             auto it = m_measure.find(e);
             if (it != m_measure.end())
                 return it->second ? "true" : "false";
@@ -75,13 +123,44 @@ namespace bloch {
         return "";
     }
 
+    std::string CppGenerator::genCall(const std::string& callee, CallExpression* call,
+                                      const std::vector<bool>& qubitParams) {
+        std::string templateArgs;
+        std::string args;
+        for (size_t i = 0; i < call->arguments.size(); ++i) {
+            bool asTemplate = m_specialised && i < qubitParams.size() && qubitParams[i];
+            std::string& list = asTemplate ? templateArgs : args;
+            if (!list.empty())
+                list += ", ";
+            list += genExpr(call->arguments[i].get());
+        }
+        if (!templateArgs.empty())
+            return callee + "<" + templateArgs + ">(" + args + ")";
+        return callee + "(" + args + ")";
+    }
+
+    std::string CppGenerator::genMeasure(Expression* qubit) {
+        if (m_specialised)
+            return std::string(kSim) + ".measure<" + genExpr(qubit) + ">()";
+        return std::string(kSim) + ".measure(" + genExpr(qubit) + ")";
+    }
+
     void CppGenerator::genStmt(Statement* s) {
         if (!s)
             return;
         if (auto var = dynamic_cast<VariableDeclaration*>(s)) {
             if (auto prim = dynamic_cast<PrimitiveType*>(var->varType.get())) {
-                if (prim->name == "qubit")
-                    return;  // omit quantum
+                if (prim->name == "qubit") {
+                    if (m_target == CppTarget::Classical)
+                        return;  // omit quantum
+                    indent();
+                    if (m_specialised)
+                        m_code += "constexpr int " + var->name + " = " +
+                                  std::to_string(m_nextQubit++) + ";\n";
+                    else
+                        m_code += "int " + var->name + " = " + kSim + ".allocateQubit();\n";
+                    return;
+                }
                 indent();
                 m_code += cppType(prim) + std::string(" ") + var->name;
                 if (var->initializer)
@@ -137,13 +216,66 @@ namespace bloch {
             genStmt(fors->body.get());
         } else if (auto echo = dynamic_cast<EchoStatement*>(s)) {
             indent();
-            m_code += "std::cout << " + genExpr(echo->value.get()) + " << std::endl;\n";
+            if (m_target == CppTarget::NativeSimulator)
+                m_code += "std::cout << " + genExpr(echo->value.get()) + " << '\\n';\n";
+            else
+                m_code += "std::cout << " + genExpr(echo->value.get()) + " << std::endl;\n";
+        } else if (auto meas = dynamic_cast<MeasureStatement*>(s)) {
+            if (m_target == CppTarget::NativeSimulator) {
+                indent();
+                m_code += genMeasure(meas->qubit.get()) + ";\n";
+            }
         } else if (auto assign = dynamic_cast<AssignmentStatement*>(s)) {
             indent();
             m_code += assign->name + " = " + genExpr(assign->value.get()) + ";\n";
         }
     }
 
+    // Qubits declared under `s`, or -1 when one is declared where it could run
+    // more than once or not at all
+    int CppGenerator::countStaticQubits(Statement* s, bool straightLine) {
+        if (auto var = dynamic_cast<VariableDeclaration*>(s)) {
+            if (!containsQubit(var->varType.get()))
+                return 0;
+            return straightLine && isQubit(var->varType.get()) ? 1 : -1;
+        }
+        std::vector<std::pair<Statement*, bool>> children;
+        if (auto block = dynamic_cast<BlockStatement*>(s)) {
+            for (auto& stmt : block->statements) children.push_back({stmt.get(), straightLine});
+        } else if (auto ifs = dynamic_cast<IfStatement*>(s)) {
+            children = {{ifs->thenBranch.get(), false}, {ifs->elseBranch.get(), false}};
+        } else if (auto fors = dynamic_cast<ForStatement*>(s)) {
+            children = {{fors->initializer.get(), false}, {fors->body.get(), false}};
+        }
+        int count = 0;
+        for (auto& [child, childStraight] : children) {
+            int n = countStaticQubits(child, childStraight);
+            if (n < 0)
+                return -1;
+            count += n;
+        }
+        return count;
+    }
+
+    int CppGenerator::staticQubitCount(Program& program) {
+        int count = 0;
+        for (auto& fn : program.functions) {
+            for (auto& param : fn->params)
+                if (containsQubit(param->type.get()) && !isQubit(param->type.get()))
+                    return -1;
+            int n = countStaticQubits(fn->body.get(), fn->name == "main");
+            if (n < 0)
+                return -1;
+            count += n;
+        }
+        return count;
+    }
+
+    bool CppGenerator::isQubit(Type* t) {
+        auto prim = dynamic_cast<PrimitiveType*>(t);
+        return prim && prim->name == "qubit";
+    }
+
     bool CppGenerator::containsQubit(Type* t) {
         if (!t)
             return false;
@@ -170,6 +302,10 @@ namespace bloch {
     }
 
     std::string CppGenerator::generate(Program& program) {
+        if (m_target == CppTarget::NativeSimulator) {
+            generateNative(program);
+            return m_code;
+        }
         m_code += "#include <iostream>\n";
         for (auto& fn : program.functions) {
             if (fn->name != "main" && !shouldSkipFunction(fn.get())) {
@@ -185,4 +321,53 @@ namespace bloch {
         return m_code;
     }
 
+    void CppGenerator::generateNative(Program& program) {
+        m_functions.clear();
+        for (auto& fn : program.functions) m_functions[fn->name] = fn.get();
+        int qubits = m_specialiseQubits ? staticQubitCount(program) : -1;
+        m_specialised = qubits >= 0;
+        m_nextQubit = 0;
+
+        m_code += "#include <cstdlib>\n#include <cstring>\n#include <iostream>\n";
+        if (m_specialised) {
+            m_code += "#include \"bloch/runtime/static_state_vector.hpp\"\n\n";
+            m_code += "static bloch::StaticStateVector<" + std::to_string(qubits) + "> " + kSim +
+                      ";\n\n";
+        } else {
+            m_code += "#include \"bloch/runtime/qasm_simulator.hpp\"\n\n";
+            m_code += "static bloch::QasmSimulator " + std::string(kSim) + "(false);\n\n";
+        }
+        // prototypes let functions call each other regardless of declaration order
+        for (auto& fn : program.functions) m_code += signature(fn.get()) + ";\n";
+        m_code += "\n";
+        for (auto& fn : program.functions) genFunction(fn.get());
+        std::string resetSim = m_specialised ? std::string(kSim) + ".reset();"
+                                             : std::string(kSim) + " = bloch::QasmSimulator(false);";
+        m_code +=
+            "extern \"C\" int bloch_run(int shots)\n"
+            "{\n"
+            "    for (int shot = 0; shot < shots; ++shot)\n"
+            "    {\n"
+            "        " +
+            resetSim +
+            "\n"
+            "        bloch_main();\n"
+            "    }\n"
+            "    std::cout.flush();\n"
+            "    return 0;\n"
+            "}\n";
+        if (m_sharedLibrary)
+            return;
+        m_code +=
+            "\n"
+            "int main(int argc, char** argv)\n"
+            "{\n"
+            "    int shots = 1;\n"
+            "    for (int i = 1; i + 1 < argc; ++i)\n"
+            "        if (std::strcmp(argv[i], \"--shots\") == 0)\n"
+            "            shots = std::atoi(argv[i + 1]);\n"
+            "    return bloch_run(shots);\n"
+            "}\n";
+    }
+
 }  // namespace bloch
\ No newline at end of file
@@ -2,27 +2,63 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "../ast/ast.hpp"
 #include "../semantics/built_ins.hpp"
 
 namespace bloch {
 
+    // Classical strips quantum operations and substitutes the measurement results
+    // recorded by an interpreted run. NativeSimulator emits calls into the
+    // bloch_runtime state vector simulator, producing a standalone program that
+    // accepts `--shots N` and exports `extern "C" int bloch_run(int shots)`.
+    enum class CppTarget { Classical, NativeSimulator };
+
+    struct CppGeneratorOptions {
+        CppTarget target = CppTarget::Classical;
+        // NativeSimulator only: when every qubit is declared once in straight-line
+        // code in `main`, emit a StaticStateVector over the constant qubit count with
+        // constexpr qubit indices. Other programs fall back to QasmSimulator.
+        bool specialiseQubits = false;
+        // NativeSimulator only: omit `main` so the program can be built as a shared
+        // object and started through its exported `int bloch_run(int shots)`
+        bool sharedLibrary = false;
+    };
+
     class CppGenerator {
        public:
         explicit CppGenerator(const std::unordered_map<const Expression*, int>& m) : m_measure(m) {}
+        explicit CppGenerator(CppTarget target);
+        explicit CppGenerator(const CppGeneratorOptions& options);
         std::string generate(Program& program);
+        // Whether the last native program was specialised on its qubit count
+        bool specialised() const { return m_specialised; }
 
        private:
         const std::unordered_map<const Expression*, int>& m_measure;
+        CppTarget m_target = CppTarget::Classical;
+        bool m_specialiseQubits = false;
+        bool m_sharedLibrary = false;
+        bool m_specialised = false;
+        int m_nextQubit = 0;
+        std::unordered_map<Symbol, FunctionDeclaration*> m_functions;
         int m_indent = 0;
         std::string m_code;
         void indent();
         std::string cppType(Type* t);
+        std::string signature(FunctionDeclaration* fn);
         void genFunction(FunctionDeclaration* fn);
         std::string genExpr(Expression* e);
+        std::string genCall(const std::string& callee, CallExpression* call,
+                            const std::vector<bool>& qubitParams);
+        std::string genMeasure(Expression* qubit);
         void genStmt(Statement* s);
+        void generateNative(Program& program);
+        int countStaticQubits(Statement* s, bool straightLine);
+        int staticQubitCount(Program& program);
         bool containsQubit(Type* t);
+        static bool isQubit(Type* t);
         bool shouldSkipFunction(FunctionDeclaration* fn);
     };
 
-}
\ No newline at end of file
+}
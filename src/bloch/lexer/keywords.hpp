@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "token.hpp"
+
+namespace bloch {
+
+    struct Keyword {
+        std::string_view text;
+        TokenType type;
+    };
+
+    inline constexpr std::array<Keyword, 25> kKeywords{{
+        // Primitives
+        {"int", TokenType::Int},
+        {"float", TokenType::Float},
+        {"string", TokenType::String},
+        {"char", TokenType::Char},
+        {"qubit", TokenType::Qubit},
+        {"bit", TokenType::Bit},
+        {"logical", TokenType::Logical},
+
+        // Keywords
+        {"void", TokenType::Void},
+        {"function", TokenType::Function},
+        {"import", TokenType::Import},
+        {"return", TokenType::Return},
+        {"if", TokenType::If},
+        {"else", TokenType::Else},
+        {"for", TokenType::For},
+        {"class", TokenType::Class},
+        {"measure", TokenType::Measure},
+        {"final", TokenType::Final},
+        {"reset", TokenType::Reset},
+        {"public", TokenType::Public},
+        {"private", TokenType::Private},
+
+        // Annotation Values
+        {"quantum", TokenType::Quantum},
+        {"adjoint", TokenType::Adjoint},
+        {"members", TokenType::Members},
+        {"methods", TokenType::Methods},
+
+        // Built ins
+        {"echo", TokenType::Echo},
+    }};
+
+    // Perfect hash over kKeywords. A keyword is keyed on its length and its
+    // first, middle and last characters, and the multiplier is searched at
+    // compile time so that every keyword lands in its own slot. Recognising a
+    // word then costs one hash, one table load and at most one comparison.
+    namespace keyword_hash {
+        inline constexpr size_t kSlots = 64;
+
+        constexpr uint32_t slot(std::string_view text, uint32_t seed) {
+            auto byte = [&](size_t i) {
+                return static_cast<uint32_t>(static_cast<uint8_t>(text[i]));
+            };
+            uint32_t key = byte(0) | byte(text.size() / 2) << 8 | byte(text.size() - 1) << 16 |
+                           static_cast<uint32_t>(text.size()) << 24;
+            uint32_t h = key * seed;
+            return (h ^ (h >> 16)) & (kSlots - 1);
+        }
+
+        constexpr bool isPerfect(uint32_t seed) {
+            std::array<bool, kSlots> used{};
+            for (const Keyword& keyword : kKeywords) {
+                uint32_t s = slot(keyword.text, seed);
+                if (used[s])
+                    return false;
+                used[s] = true;
+            }
+            return true;
+        }
+
+        constexpr uint32_t findSeed() {
+            for (uint32_t seed = 1; seed < 1u << 16; seed += 2)
+                if (isPerfect(seed))
+                    return seed;
+            return 0;
+        }
+
+        inline constexpr uint32_t kSeed = findSeed();
+        static_assert(kSeed != 0, "no collision-free seed for the keyword set; widen kSlots");
+
+        constexpr size_t lengthBound(bool longest) {
+            size_t bound = kKeywords[0].text.size();
+            for (const Keyword& keyword : kKeywords)
+                bound = longest ? std::max(bound, keyword.text.size())
+                                : std::min(bound, keyword.text.size());
+            return bound;
+        }
+
+        inline constexpr size_t kMinLength = lengthBound(false);
+        inline constexpr size_t kMaxLength = lengthBound(true);
+
+        // Index into kKeywords plus one, or zero for an empty slot
+        inline constexpr auto kTable = [] {
+            std::array<uint8_t, kSlots> table{};
+            for (size_t i = 0; i < kKeywords.size(); ++i)
+                table[slot(kKeywords[i].text, kSeed)] = static_cast<uint8_t>(i + 1);
+            return table;
+        }();
+    }
+
+    // The keyword token type for `text`, or TokenType::Identifier
+    constexpr TokenType keywordType(std::string_view text) {
+        using namespace keyword_hash;
+        if (text.size() < kMinLength || text.size() > kMaxLength)
+            return TokenType::Identifier;
+        uint8_t entry = kTable[slot(text, kSeed)];
+        if (entry && kKeywords[entry - 1].text == text)
+            return kKeywords[entry - 1].type;
+        return TokenType::Identifier;
+    }
+
+    namespace keyword_hash {
+        constexpr bool recognisesEveryKeyword() {
+            for (const Keyword& keyword : kKeywords)
+                if (keywordType(keyword.text) != keyword.type)
+                    return false;
+            return true;
+        }
+        static_assert(recognisesEveryKeyword(), "keyword table lost a keyword");
+        static_assert(keywordType("inte") == TokenType::Identifier &&
+                          keywordType("method") == TokenType::Identifier &&
+                          keywordType("x") == TokenType::Identifier,
+                      "keyword table accepts a non-keyword");
+    }
+
+}
@@ -1,29 +1,99 @@
 #include "lexer.hpp"
 
 #include <cctype>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <string_view>
-#include <unordered_map>
 #include "../error/bloch_runtime_error.hpp"
+#include "keywords.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace bloch {
+    namespace {
+        // Whitespace as classified by isspace in the C locale
+        constexpr bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+#if defined(__SSE2__)
+        // Bit i is set when byte i of `chunk` is whitespace
+        inline uint32_t spaceMask(__m128i chunk) {
+            __m128i control = _mm_sub_epi8(chunk, _mm_set1_epi8('\t'));
+            __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control);
+            __m128i isBlank = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(isControl, isBlank)));
+        }
+
+        inline uint32_t newlineMask(__m128i chunk) {
+            return static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+        }
+#endif
+
+        // Consumes the first `run` bytes of a 16-byte block starting at `pos`,
+        // counting the newlines among them
+        inline void passNewlines(uint32_t newlines, uint32_t run, size_t pos, int& line,
+                                 size_t& lineStart) {
+            if (run < 16)
+                newlines &= (1u << run) - 1;
+            if (newlines) {
+                line += __builtin_popcount(newlines);
+                lineStart = pos + (31 - __builtin_clz(newlines)) + 1;
+            }
+        }
+
+        // Returns the first non-whitespace offset at or after `pos`, sixteen
+        // bytes at a time where SSE2 is available
+        size_t skipSpaces(std::string_view src, size_t pos, int& line, size_t& lineStart) {
+            const char* data = src.data();
+            size_t size = src.size();
+#if defined(__SSE2__)
+            while (pos + 16 <= size) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                uint32_t spaces = spaceMask(chunk);
+                uint32_t run = spaces != 0xffff ? __builtin_ctz(~spaces) : 16;
+                passNewlines(newlineMask(chunk), run, pos, line, lineStart);
+                pos += run;
+                if (run < 16)
+                    return pos;
+            }
+#endif
+            for (; pos < size && isSpace(data[pos]); ++pos) {
+                if (data[pos] == '\n') {
+                    ++line;
+                    lineStart = pos + 1;
+                }
+            }
+            return pos;
+        }
+    }
+
     Lexer::Lexer(const std::string_view source) noexcept
-        : m_source(source), m_position(0), m_line(1), m_column(1) {}
+        : m_source(source), m_position(0), m_line(1), m_lineStart(0) {}
 
     std::vector<Token> Lexer::tokenize() {
         std::vector<Token> tokens;
-        while (m_position < m_source.size()) {
-            skipWhitespace();
-            if (m_position < m_source.size()) {
-                tokens.push_back(scanToken());
-            }
-        }
-        tokens.push_back(makeToken(TokenType::Eof, ""));
+        // tokens view the source, so this is usually the only allocation
+        tokens.reserve(m_source.size() / 8 + 1);
+        do {
+            tokens.push_back(next());
+        } while (tokens.back().type != TokenType::Eof);
         return tokens;
     }
 
+    Token Lexer::next() {
+        skipWhitespace();
+        m_tokenLine = m_line;
+        m_tokenColumn = column();
+        if (m_position >= m_source.size())
+            return makeToken(TokenType::Eof, "");
+        return scanToken();
+    }
+
     char Lexer::peek() const noexcept {
         return m_position < m_source.size() ? m_source[m_position] : '\0';
     }
@@ -32,35 +102,26 @@ namespace bloch {
         return (m_position + 1) < m_source.size() ? m_source[m_position + 1] : '\0';
     }
 
-    char Lexer::advance() noexcept {
-        char c = m_source[m_position++];
-        m_column++;
-        return c;
-    }
+    char Lexer::advance() noexcept { return m_source[m_position++]; }
 
     bool Lexer::match(char expected) noexcept {
         if (m_position >= m_source.size() || m_source[m_position] != expected) {
             return false;
         }
         m_position++;
-        m_column++;
         return true;
     }
 
     void Lexer::skipWhitespace() {
         while (m_position < m_source.size()) {
-            char c = peek();
-            if (isspace(c)) {
-                if (c == '\n') {
-                    (void)advance();
-                    m_line++;
-                    m_column = 1;
-                    continue;
-                }
-                (void)advance();
+            char c = m_source[m_position];
+            if (c == ' ' && !isSpace(peekNext())) {
+                // a single separating space is the common case between tokens
+                m_position++;
+            } else if (isSpace(c)) {
+                m_position = skipSpaces(m_source, m_position, m_line, m_lineStart);
             } else if (c == '/' && peekNext() == '/') {
-                (void)advance();
-                (void)advance();
+                m_position += 2;
                 skipComment();
             } else {
                 break;
@@ -68,18 +129,22 @@ namespace bloch {
         }
     }
 
+    // Stops at the newline, which skipWhitespace then counts
     void Lexer::skipComment() {
-        while (m_position < m_source.size() && m_source[m_position] != '\n') {
-            (void)advance();
-        }
+        const void* newline =
+            std::memchr(m_source.data() + m_position, '\n', m_source.size() - m_position);
+        m_position = newline ? static_cast<const char*>(newline) - m_source.data()
+                             : m_source.size();
     }
 
+    int Lexer::column() const noexcept { return static_cast<int>(m_position - m_lineStart) + 1; }
+
     void Lexer::reportError(const std::string& msg) {
-        throw BlochRuntimeError("Bloch Lexer Error", m_line, m_column, msg);
+        throw BlochRuntimeError("Bloch Lexer Error", m_line, column(), msg);
     }
 
-    Token Lexer::makeToken(TokenType type, const std::string& value) {
-        return Token{type, value, m_line, m_column - static_cast<int>(value.length())};
+    Token Lexer::makeToken(TokenType type, std::string_view value) {
+        return Token{type, Symbol(), value, m_tokenLine, m_tokenColumn};
     }
 
     Token Lexer::scanToken() {
@@ -141,7 +206,7 @@ namespace bloch {
             case ']':
                 return makeToken(TokenType::RBracket, "]");
             default:
-                return makeToken(TokenType::Unknown, std::string(1, c));
+                return makeToken(TokenType::Unknown, m_source.substr(m_position - 1, 1));
         }
     }
 
@@ -155,15 +220,13 @@ namespace bloch {
             if (peek() == 'f') {
                 (void)advance();
                 return makeToken(TokenType::FloatLiteral,
-                                 std::string(m_source.substr(start, m_position - start)));
+                                 m_source.substr(start, m_position - start));
             } else {
                 reportError("Float literal must end with 'f'");
-                return makeToken(TokenType::Unknown,
-                                 std::string(m_source.substr(start, m_position - start)));
+                return makeToken(TokenType::Unknown, m_source.substr(start, m_position - start));
             }
         }
-        return makeToken(TokenType::IntegerLiteral,
-                         std::string(m_source.substr(start, m_position - start)));
+        return makeToken(TokenType::IntegerLiteral, m_source.substr(start, m_position - start));
     }
 
     Token Lexer::scanIdentifierOrKeyword() {
@@ -172,66 +235,32 @@ namespace bloch {
 
         std::string_view text = m_source.substr(start, m_position - start);
 
-        static const std::unordered_map<std::string_view, TokenType> keywords = {
-
-            // Primitives
-            {"int", TokenType::Int},
-            {"float", TokenType::Float},
-            {"string", TokenType::String},
-            {"char", TokenType::Char},
-            {"qubit", TokenType::Qubit},
-            {"bit", TokenType::Bit},
-            {"logical", TokenType::Logical},
-
-            // Keywords
-            {"void", TokenType::Void},
-            {"function", TokenType::Function},
-            {"import", TokenType::Import},
-            {"return", TokenType::Return},
-            {"if", TokenType::If},
-            {"else", TokenType::Else},
-            {"for", TokenType::For},
-            {"class", TokenType::Class},
-            {"measure", TokenType::Measure},
-            {"final", TokenType::Final},
-            {"reset", TokenType::Reset},
-            {"public", TokenType::Public},
-            {"private", TokenType::Private},
-
-            // Annotation Values
-            {"quantum", TokenType::Quantum},
-            {"adjoint", TokenType::Adjoint},
-            {"members", TokenType::Members},
-            {"methods", TokenType::Methods},
-
-            // Built ins
-            {"echo", TokenType::Echo}};
-
-        auto it = keywords.find(text);
-        if (it != keywords.end()) {
-            return makeToken(it->second, std::string(text));
-        }
+        TokenType type = keywordType(text);
+        if (type != TokenType::Identifier)
+            return makeToken(type, text);
 
-        return makeToken(TokenType::Identifier, std::string(text));
+        Token token = makeToken(TokenType::Identifier, text);
+        token.symbol = Symbol(text);
+        return token;
     }
 
     Token Lexer::scanString() {
         size_t start = m_position;
         while (m_position < m_source.size() && peek() != '"') {
-            if (peek() == '\n')
+            if (advance() == '\n') {
                 m_line++;
-            (void)advance();
+                m_lineStart = m_position;
+            }
         }
 
         if (peek() == '"') {
             (void)advance();
             return makeToken(TokenType::StringLiteral,
-                             std::string(m_source.substr(start - 1, m_position - start + 1)));
+                             m_source.substr(start - 1, m_position - start + 1));
         }
 
         reportError("Unterminated string literal");
-        return makeToken(TokenType::Unknown,
-                         std::string(m_source.substr(start - 1, m_position - start + 1)));
+        return makeToken(TokenType::Unknown, m_source.substr(start - 1, m_position - start + 1));
     }
 
     Token Lexer::scanChar() {
@@ -241,11 +270,10 @@ namespace bloch {
 
         if (peek() == '\'') {
             (void)advance();
-            return makeToken(TokenType::CharLiteral, std::string(m_source.substr(start - 1, 3)));
+            return makeToken(TokenType::CharLiteral, m_source.substr(start - 1, 3));
         }
 
         reportError("Unterminated char literal");
-        return makeToken(TokenType::Unknown,
-                         std::string(m_source.substr(start - 1, m_position - start + 1)));
+        return makeToken(TokenType::Unknown, m_source.substr(start - 1, m_position - start + 1));
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include "../error/bloch_runtime_error.hpp"
 #include "token.hpp"
@@ -10,12 +11,18 @@ namespace bloch {
        public:
         explicit Lexer(const std::string_view source) noexcept;
         [[nodiscard]] std::vector<Token> tokenize();
+        // Scans the next token on demand, returning Eof repeatedly at the end
+        [[nodiscard]] Token next();
 
        private:
         std::string_view m_source;
         size_t m_position;
+        // Columns are derived from the offset of the current line's start
+        // rather than tracked per character
         int m_line;
-        int m_column;
+        size_t m_lineStart;
+        int m_tokenLine = 1;
+        int m_tokenColumn = 1;
 
         [[nodiscard]] char peek() const noexcept;
         [[nodiscard]] char peekNext() const noexcept;
@@ -25,9 +32,10 @@ namespace bloch {
 
         void skipWhitespace();
         void skipComment();
+        [[nodiscard]] int column() const noexcept;
         [[noreturn]] void reportError(const std::string& msg);
 
-        [[nodiscard]] Token makeToken(TokenType type, const std::string& value);
+        [[nodiscard]] Token makeToken(TokenType type, std::string_view value);
         [[nodiscard]] Token scanToken();
         [[nodiscard]] Token scanNumber();
         [[nodiscard]] Token scanIdentifierOrKeyword();
@@ -0,0 +1,90 @@
+#include "source_file.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace bloch {
+
+    namespace {
+        struct FileDescriptor {
+            int fd;
+            ~FileDescriptor() {
+                if (fd >= 0)
+                    ::close(fd);
+            }
+        };
+
+        [[noreturn]] void fail(const std::string& path) {
+            throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    SourceFile::SourceFile(const std::string& path) {
+        FileDescriptor file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (file.fd < 0)
+            fail(path);
+        struct stat info {};
+        if (::fstat(file.fd, &info) != 0)
+            fail(path);
+
+        bool regular = S_ISREG(info.st_mode);
+        if (regular && info.st_size > 0) {
+            void* mapping = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+            if (mapping != MAP_FAILED) {
+                ::madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+                m_mapping = mapping;
+                m_size = info.st_size;
+                return;
+            }
+        }
+
+        // a regular file is read in one call; pipes are read until EOF
+        size_t chunk = regular && info.st_size > 0 ? info.st_size : 64 * 1024;
+        for (;;) {
+            size_t used = m_buffer.size();
+            m_buffer.resize(used + chunk);
+            ssize_t got = ::read(file.fd, m_buffer.data() + used, chunk);
+            if (got < 0) {
+                if (errno == EINTR) {
+                    m_buffer.resize(used);
+                    continue;
+                }
+                fail(path);
+            }
+            m_buffer.resize(used + got);
+            if (got == 0)
+                break;
+            chunk = 64 * 1024;
+        }
+    }
+
+    SourceFile::~SourceFile() { release(); }
+
+    SourceFile::SourceFile(SourceFile&& other) noexcept
+        : m_mapping(std::exchange(other.m_mapping, nullptr)),
+          m_size(std::exchange(other.m_size, 0)),
+          m_buffer(std::move(other.m_buffer)) {}
+
+    SourceFile& SourceFile::operator=(SourceFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_buffer = std::move(other.m_buffer);
+        }
+        return *this;
+    }
+
+    void SourceFile::release() noexcept {
+        if (m_mapping)
+            ::munmap(m_mapping, m_size);
+        m_mapping = nullptr;
+        m_size = 0;
+    }
+
+}
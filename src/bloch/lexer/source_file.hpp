@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace bloch {
+
+    // The contents of a source file. Regular files are mapped read-only;
+    // anything that cannot be mapped (pipes, empty files) is read in bulk.
+    // Tokens view this text, so it must outlive them.
+    class SourceFile {
+       public:
+        // Throws std::runtime_error when the file cannot be opened or read
+        explicit SourceFile(const std::string& path);
+        ~SourceFile();
+        SourceFile(SourceFile&& other) noexcept;
+        SourceFile& operator=(SourceFile&& other) noexcept;
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
+
+        std::string_view text() const {
+            return m_mapping ? std::string_view(static_cast<const char*>(m_mapping), m_size)
+                             : std::string_view(m_buffer);
+        }
+        bool mapped() const { return m_mapping != nullptr; }
+
+       private:
+        void* m_mapping = nullptr;
+        size_t m_size = 0;
+        std::string m_buffer;
+
+        void release() noexcept;
+    };
+
+}
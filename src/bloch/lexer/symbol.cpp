@@ -0,0 +1,89 @@
+#include "symbol.hpp"
+#include <deque>
+#include <vector>
+
+namespace bloch {
+
+    namespace {
+        // Open-addressed table of ids keyed by spelling. Slots keep the hash so
+        // probes only compare spellings on a likely match.
+        class Interner {
+           public:
+            Interner() : m_slots(kInitialSlots) {
+                m_names.emplace_back();
+                m_views.emplace_back();
+            }
+
+            uint32_t intern(std::string_view text) {
+                if (text.empty())
+                    return 0;
+                uint32_t hash = hashOf(text);
+                size_t mask = m_slots.size() - 1;
+                for (size_t i = hash & mask;; i = (i + 1) & mask) {
+                    Slot& slot = m_slots[i];
+                    if (slot.id == 0)
+                        return insert(slot, hash, text);
+                    if (slot.hash == hash && m_views[slot.id] == text)
+                        return slot.id;
+                }
+            }
+
+            const std::string& name(uint32_t id) const { return m_names[id]; }
+            size_t size() const { return m_names.size(); }
+
+           private:
+            struct Slot {
+                uint32_t hash = 0;
+                uint32_t id = 0;  // 0 marks an empty slot
+            };
+            static constexpr size_t kInitialSlots = 1024;
+
+            std::vector<Slot> m_slots;
+            // a deque never moves its strings, so views of them stay valid
+            std::deque<std::string> m_names;
+            std::vector<std::string_view> m_views;
+
+            // FNV-1a, which is quick on short identifiers
+            static uint32_t hashOf(std::string_view text) {
+                uint32_t hash = 2166136261u;
+                for (unsigned char c : text) hash = (hash ^ c) * 16777619u;
+                return hash;
+            }
+
+            uint32_t insert(Slot& slot, uint32_t hash, std::string_view text) {
+                auto id = static_cast<uint32_t>(m_names.size());
+                m_views.push_back(m_names.emplace_back(text));
+                slot = {hash, id};
+                // keep the load factor under a half
+                if (m_names.size() * 2 > m_slots.size())
+                    grow();
+                return id;
+            }
+
+            void grow() {
+                std::vector<Slot> slots(m_slots.size() * 2);
+                size_t mask = slots.size() - 1;
+                for (const Slot& slot : m_slots) {
+                    if (slot.id == 0)
+                        continue;
+                    size_t i = slot.hash & mask;
+                    while (slots[i].id != 0) i = (i + 1) & mask;
+                    slots[i] = slot;
+                }
+                m_slots.swap(slots);
+            }
+        };
+
+        Interner& interner() {
+            static Interner table;
+            return table;
+        }
+    }
+
+    uint32_t Symbol::intern(std::string_view text) { return interner().intern(text); }
+
+    const std::string& Symbol::str() const { return interner().name(m_id); }
+
+    size_t Symbol::count() { return interner().size(); }
+
+}
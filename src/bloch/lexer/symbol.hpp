@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace bloch {
+
+    // An interned identifier. The lexer interns each name once into a
+    // process-wide table, so later stages compare and hash names as integers.
+    // Interned spellings are never freed. The table is not synchronised, which
+    // matches the single-threaded compiler.
+    class Symbol {
+       public:
+        // The empty name
+        Symbol() = default;
+        explicit Symbol(std::string_view text) : m_id(intern(text)) {}
+
+        Symbol& operator=(std::string_view text) {
+            m_id = intern(text);
+            return *this;
+        }
+
+        uint32_t id() const { return m_id; }
+        bool empty() const { return m_id == 0; }
+        const std::string& str() const;
+        operator const std::string&() const { return str(); }
+
+        friend bool operator==(Symbol a, Symbol b) { return a.m_id == b.m_id; }
+        friend bool operator==(Symbol a, std::string_view b) { return a.str() == b; }
+
+        // Number of distinct names interned so far, including the empty name
+        static size_t count();
+
+       private:
+        uint32_t m_id = 0;
+
+        static uint32_t intern(std::string_view text);
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, Symbol symbol) {
+        return out << symbol.str();
+    }
+
+    // Spelling concatenation, for diagnostics and generated names
+    inline std::string operator+(const std::string& text, Symbol symbol) {
+        return text + symbol.str();
+    }
+    inline std::string operator+(const char* text, Symbol symbol) { return text + symbol.str(); }
+    inline std::string operator+(Symbol symbol, const std::string& text) {
+        return symbol.str() + text;
+    }
+    inline std::string operator+(Symbol symbol, const char* text) { return symbol.str() + text; }
+
+}
+
+template <>
+struct std::hash<bloch::Symbol> {
+    size_t operator()(bloch::Symbol symbol) const noexcept { return symbol.id(); }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <string>
+#include <string_view>
+#include "symbol.hpp"
 
 namespace bloch {
     enum class TokenType {
@@ -74,9 +75,14 @@ namespace bloch {
         Unknown
     };
 
+    // `value` views the source text given to the Lexer, which must outlive the
+    // tokens, or a static spelling for operators and punctuation. The parser
+    // copies the parts it keeps into the AST. Identifiers also carry their
+    // interned symbol.
     struct Token {
         TokenType type;
-        std::string value;
+        Symbol symbol;
+        std::string_view value;
         int line;
         int column;
     };
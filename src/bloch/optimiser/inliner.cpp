@@ -0,0 +1,442 @@
+#include "inliner.hpp"
+#include "../semantics/built_ins.hpp"
+
+namespace bloch {
+
+    namespace {
+        using Renames = std::unordered_map<Symbol, Symbol>;
+
+        Symbol renamed(const Renames& renames, Symbol name) {
+            auto it = renames.find(name);
+            return it == renames.end() ? name : it->second;
+        }
+
+        template <typename T>
+        std::unique_ptr<T> located(std::unique_ptr<T> node, const ASTNode& origin) {
+            node->line = origin.line;
+            node->column = origin.column;
+            return node;
+        }
+
+        std::unique_ptr<Type> cloneType(Type* t) {
+            if (!t)
+                return nullptr;
+            if (auto prim = dynamic_cast<PrimitiveType*>(t))
+                return located(std::make_unique<PrimitiveType>(prim->name), *t);
+            if (auto logical = dynamic_cast<LogicalType*>(t))
+                return located(std::make_unique<LogicalType>(logical->code), *t);
+            if (auto arr = dynamic_cast<ArrayType*>(t))
+                return located(std::make_unique<ArrayType>(cloneType(arr->elementType.get())), *t);
+            if (auto obj = dynamic_cast<ObjectType*>(t))
+                return located(std::make_unique<ObjectType>(obj->className), *t);
+            return located(std::make_unique<VoidType>(), *t);
+        }
+
+        std::unique_ptr<Expression> cloneExpr(Expression* e, const Renames& renames);
+
+        std::vector<std::unique_ptr<Expression>> cloneArgs(
+            const std::vector<std::unique_ptr<Expression>>& args, const Renames& renames) {
+            std::vector<std::unique_ptr<Expression>> out;
+            out.reserve(args.size());
+            for (auto& arg : args) out.push_back(cloneExpr(arg.get(), renames));
+            return out;
+        }
+
+        std::unique_ptr<Expression> cloneExpr(Expression* e, const Renames& renames) {
+            if (!e)
+                return nullptr;
+            std::unique_ptr<Expression> out;
+            if (auto lit = dynamic_cast<LiteralExpression*>(e)) {
+                out = std::make_unique<LiteralExpression>(lit->value, lit->literalType, lit->line,
+                                                          lit->column);
+            } else if (auto var = dynamic_cast<VariableExpression*>(e)) {
+                out = std::make_unique<VariableExpression>(renamed(renames, var->name));
+            } else if (auto bin = dynamic_cast<BinaryExpression*>(e)) {
+                out = std::make_unique<BinaryExpression>(bin->op,
+                                                         cloneExpr(bin->left.get(), renames),
+                                                         cloneExpr(bin->right.get(), renames));
+            } else if (auto unary = dynamic_cast<UnaryExpression*>(e)) {
+                out = std::make_unique<UnaryExpression>(unary->op,
+                                                        cloneExpr(unary->right.get(), renames));
+            } else if (auto call = dynamic_cast<CallExpression*>(e)) {
+                // callees name functions, which are never renamed
+                out = std::make_unique<CallExpression>(cloneExpr(call->callee.get(), {}),
+                                                       cloneArgs(call->arguments, renames));
+            } else if (auto idx = dynamic_cast<IndexExpression*>(e)) {
+                auto copy = std::make_unique<IndexExpression>();
+                copy->collection = cloneExpr(idx->collection.get(), renames);
+                copy->index = cloneExpr(idx->index.get(), renames);
+                out = std::move(copy);
+            } else if (auto paren = dynamic_cast<ParenthesizedExpression*>(e)) {
+                out = std::make_unique<ParenthesizedExpression>(
+                    cloneExpr(paren->expression.get(), renames));
+            } else if (auto meas = dynamic_cast<MeasureExpression*>(e)) {
+                out = std::make_unique<MeasureExpression>(cloneExpr(meas->qubit.get(), renames));
+            } else if (auto assign = dynamic_cast<AssignmentExpression*>(e)) {
+                out = std::make_unique<AssignmentExpression>(
+                    renamed(renames, assign->name), cloneExpr(assign->value.get(), renames));
+            } else if (auto ctor = dynamic_cast<ConstructorCallExpression*>(e)) {
+                out = std::make_unique<ConstructorCallExpression>(
+                    ctor->className, cloneArgs(ctor->arguments, renames));
+            } else if (auto member = dynamic_cast<MemberAccessExpression*>(e)) {
+                out = std::make_unique<MemberAccessExpression>(
+                    cloneExpr(member->object.get(), renames), member->member);
+            } else {
+                return nullptr;
+            }
+            return located(std::move(out), *e);
+        }
+
+        std::unique_ptr<Statement> cloneStmt(Statement* s, const Renames& renames) {
+            if (!s)
+                return nullptr;
+            std::unique_ptr<Statement> out;
+            if (auto var = dynamic_cast<VariableDeclaration*>(s)) {
+                auto copy = std::make_unique<VariableDeclaration>();
+                copy->name = renamed(renames, var->name);
+                copy->access = var->access;
+                copy->varType = cloneType(var->varType.get());
+                copy->initializer = cloneExpr(var->initializer.get(), renames);
+                for (auto& ann : var->annotations)
+                    copy->annotations.push_back(
+                        std::make_unique<AnnotationNode>(ann->name, ann->value));
+                copy->isFinal = var->isFinal;
+                out = std::move(copy);
+            } else if (auto block = dynamic_cast<BlockStatement*>(s)) {
+                auto copy = std::make_unique<BlockStatement>();
+                for (auto& stmt : block->statements)
+                    copy->statements.push_back(cloneStmt(stmt.get(), renames));
+                out = std::move(copy);
+            } else if (auto exprs = dynamic_cast<ExpressionStatement*>(s)) {
+                auto copy = std::make_unique<ExpressionStatement>();
+                copy->expression = cloneExpr(exprs->expression.get(), renames);
+                out = std::move(copy);
+            } else if (auto ret = dynamic_cast<ReturnStatement*>(s)) {
+                auto copy = std::make_unique<ReturnStatement>();
+                copy->value = cloneExpr(ret->value.get(), renames);
+                out = std::move(copy);
+            } else if (auto ifs = dynamic_cast<IfStatement*>(s)) {
+                auto copy = std::make_unique<IfStatement>();
+                copy->condition = cloneExpr(ifs->condition.get(), renames);
+                copy->thenBranch = cloneStmt(ifs->thenBranch.get(), renames);
+                copy->elseBranch = cloneStmt(ifs->elseBranch.get(), renames);
+                out = std::move(copy);
+            } else if (auto fors = dynamic_cast<ForStatement*>(s)) {
+                auto copy = std::make_unique<ForStatement>();
+                copy->initializer = cloneStmt(fors->initializer.get(), renames);
+                copy->condition = cloneExpr(fors->condition.get(), renames);
+                copy->increment = cloneExpr(fors->increment.get(), renames);
+                copy->body = cloneStmt(fors->body.get(), renames);
+                out = std::move(copy);
+            } else if (auto echo = dynamic_cast<EchoStatement*>(s)) {
+                auto copy = std::make_unique<EchoStatement>();
+                copy->value = cloneExpr(echo->value.get(), renames);
+                out = std::move(copy);
+            } else if (auto reset = dynamic_cast<ResetStatement*>(s)) {
+                auto copy = std::make_unique<ResetStatement>();
+                copy->target = cloneExpr(reset->target.get(), renames);
+                out = std::move(copy);
+            } else if (auto meas = dynamic_cast<MeasureStatement*>(s)) {
+                auto copy = std::make_unique<MeasureStatement>();
+                copy->qubit = cloneExpr(meas->qubit.get(), renames);
+                out = std::move(copy);
+            } else if (auto assign = dynamic_cast<AssignmentStatement*>(s)) {
+                auto copy = std::make_unique<AssignmentStatement>();
+                copy->name = renamed(renames, assign->name);
+                copy->value = cloneExpr(assign->value.get(), renames);
+                out = std::move(copy);
+            } else {
+                return nullptr;
+            }
+            return located(std::move(out), *s);
+        }
+
+        // Walks every statement and expression below a statement
+        template <typename StmtFn, typename ExprFn>
+        void walk(Statement* s, StmtFn& onStmt, ExprFn& onExpr);
+
+        template <typename ExprFn>
+        void walkExpr(Expression* e, ExprFn& onExpr) {
+            if (!e)
+                return;
+            onExpr(e);
+            if (auto bin = dynamic_cast<BinaryExpression*>(e)) {
+                walkExpr(bin->left.get(), onExpr);
+                walkExpr(bin->right.get(), onExpr);
+            } else if (auto unary = dynamic_cast<UnaryExpression*>(e)) {
+                walkExpr(unary->right.get(), onExpr);
+            } else if (auto call = dynamic_cast<CallExpression*>(e)) {
+                walkExpr(call->callee.get(), onExpr);
+                for (auto& arg : call->arguments) walkExpr(arg.get(), onExpr);
+            } else if (auto idx = dynamic_cast<IndexExpression*>(e)) {
+                walkExpr(idx->collection.get(), onExpr);
+                walkExpr(idx->index.get(), onExpr);
+            } else if (auto paren = dynamic_cast<ParenthesizedExpression*>(e)) {
+                walkExpr(paren->expression.get(), onExpr);
+            } else if (auto meas = dynamic_cast<MeasureExpression*>(e)) {
+                walkExpr(meas->qubit.get(), onExpr);
+            } else if (auto assign = dynamic_cast<AssignmentExpression*>(e)) {
+                walkExpr(assign->value.get(), onExpr);
+            } else if (auto ctor = dynamic_cast<ConstructorCallExpression*>(e)) {
+                for (auto& arg : ctor->arguments) walkExpr(arg.get(), onExpr);
+            } else if (auto member = dynamic_cast<MemberAccessExpression*>(e)) {
+                walkExpr(member->object.get(), onExpr);
+            }
+        }
+
+        template <typename StmtFn, typename ExprFn>
+        void walk(Statement* s, StmtFn& onStmt, ExprFn& onExpr) {
+            if (!s)
+                return;
+            onStmt(s);
+            if (auto var = dynamic_cast<VariableDeclaration*>(s)) {
+                walkExpr(var->initializer.get(), onExpr);
+            } else if (auto block = dynamic_cast<BlockStatement*>(s)) {
+                for (auto& stmt : block->statements) walk(stmt.get(), onStmt, onExpr);
+            } else if (auto exprs = dynamic_cast<ExpressionStatement*>(s)) {
+                walkExpr(exprs->expression.get(), onExpr);
+            } else if (auto ret = dynamic_cast<ReturnStatement*>(s)) {
+                walkExpr(ret->value.get(), onExpr);
+            } else if (auto ifs = dynamic_cast<IfStatement*>(s)) {
+                walkExpr(ifs->condition.get(), onExpr);
+                walk(ifs->thenBranch.get(), onStmt, onExpr);
+                walk(ifs->elseBranch.get(), onStmt, onExpr);
+            } else if (auto fors = dynamic_cast<ForStatement*>(s)) {
+                walk(fors->initializer.get(), onStmt, onExpr);
+                walkExpr(fors->condition.get(), onExpr);
+                walkExpr(fors->increment.get(), onExpr);
+                walk(fors->body.get(), onStmt, onExpr);
+            } else if (auto echo = dynamic_cast<EchoStatement*>(s)) {
+                walkExpr(echo->value.get(), onExpr);
+            } else if (auto reset = dynamic_cast<ResetStatement*>(s)) {
+                walkExpr(reset->target.get(), onExpr);
+            } else if (auto meas = dynamic_cast<MeasureStatement*>(s)) {
+                walkExpr(meas->qubit.get(), onExpr);
+            } else if (auto assign = dynamic_cast<AssignmentStatement*>(s)) {
+                walkExpr(assign->value.get(), onExpr);
+            }
+        }
+
+        bool isAssigned(BlockStatement* body, Symbol name) {
+            bool assigned = false;
+            auto onStmt = [&](Statement* s) {
+                if (auto assign = dynamic_cast<AssignmentStatement*>(s))
+                    assigned |= assign->name == name;
+            };
+            auto onExpr = [&](Expression* e) {
+                if (auto assign = dynamic_cast<AssignmentExpression*>(e))
+                    assigned |= assign->name == name;
+            };
+            walk(body, onStmt, onExpr);
+            return assigned;
+        }
+
+        bool isTrivial(Expression* e) {
+            return dynamic_cast<LiteralExpression*>(e) || dynamic_cast<VariableExpression*>(e);
+        }
+    }
+
+    void Inliner::inlineCalls(Program& program) {
+        // inlined copies live alongside the rest of the tree
+        AstArena::Scope arena(program.arena.get());
+        buildCallGraph(program);
+        for (auto& fn : program.functions) process(fn.get());
+    }
+
+    void Inliner::buildCallGraph(Program& program) {
+        for (auto& fn : program.functions) m_functions[fn->name] = fn.get();
+        for (auto& fn : program.functions) {
+            auto& callees = m_callGraph[fn->name];
+            auto onStmt = [](Statement*) {};
+            auto onExpr = [&](Expression* e) {
+                if (auto call = dynamic_cast<CallExpression*>(e))
+                    if (auto var = dynamic_cast<VariableExpression*>(call->callee.get()))
+                        if (m_functions.count(var->name))
+                            callees.insert(var->name);
+            };
+            walk(fn->body.get(), onStmt, onExpr);
+        }
+        for (auto& fn : program.functions) {
+            std::unordered_set<Symbol> seen;
+            if (reaches(fn->name, fn->name, seen))
+                m_recursive.insert(fn->name);
+        }
+    }
+
+    bool Inliner::reaches(Symbol from, Symbol target, std::unordered_set<Symbol>& seen) const {
+        auto it = m_callGraph.find(from);
+        if (it == m_callGraph.end())
+            return false;
+        for (auto& callee : it->second) {
+            if (callee == target)
+                return true;
+            if (seen.insert(callee).second && reaches(callee, target, seen))
+                return true;
+        }
+        return false;
+    }
+
+    // Callees are processed first so their bodies are already expanded when copied
+    void Inliner::process(FunctionDeclaration* fn) {
+        if (!fn || !m_done.insert(fn->name).second)
+            return;
+        for (auto& callee : m_callGraph[fn->name]) process(m_functions[callee]);
+        if (fn->body)
+            inlineInto(fn->body->statements);
+    }
+
+    void Inliner::inlineInto(std::vector<std::unique_ptr<Statement>>& statements) {
+        std::vector<std::unique_ptr<Statement>> out;
+        out.reserve(statements.size());
+        for (auto& stmt : statements) {
+            if (auto block = dynamic_cast<BlockStatement*>(stmt.get())) {
+                inlineInto(block->statements);
+            } else if (auto ifs = dynamic_cast<IfStatement*>(stmt.get())) {
+                if (auto then = dynamic_cast<BlockStatement*>(ifs->thenBranch.get()))
+                    inlineInto(then->statements);
+                if (auto otherwise = dynamic_cast<BlockStatement*>(ifs->elseBranch.get()))
+                    inlineInto(otherwise->statements);
+            } else if (auto fors = dynamic_cast<ForStatement*>(stmt.get())) {
+                if (auto body = dynamic_cast<BlockStatement*>(fors->body.get()))
+                    inlineInto(body->statements);
+            }
+            if (!expand(stmt, out))
+                out.push_back(std::move(stmt));
+        }
+        statements = std::move(out);
+    }
+
+    bool Inliner::expand(std::unique_ptr<Statement>& stmt,
+                         std::vector<std::unique_ptr<Statement>>& out) {
+        std::unique_ptr<Expression>* slot = nullptr;
+        bool wholeStatement = false;
+        if (auto exprs = dynamic_cast<ExpressionStatement*>(stmt.get())) {
+            slot = &exprs->expression;
+            wholeStatement = true;
+        } else if (auto var = dynamic_cast<VariableDeclaration*>(stmt.get())) {
+            slot = &var->initializer;
+        } else if (auto assign = dynamic_cast<AssignmentStatement*>(stmt.get())) {
+            slot = &assign->value;
+        } else if (auto ret = dynamic_cast<ReturnStatement*>(stmt.get())) {
+            slot = &ret->value;
+        }
+        if (!slot || !*slot)
+            return false;
+        FunctionDeclaration* fn = inlineTarget(slot->get());
+        if (!fn)
+            return false;
+        auto call = static_cast<CallExpression*>(slot->get());
+        if (call->arguments.size() != fn->params.size())
+            return false;
+
+        std::string prefix = "_inl" + std::to_string(m_nextId) + "_";
+        Renames renames;
+        for (size_t i = 0; i < fn->params.size(); ++i) {
+            auto& param = fn->params[i];
+            auto prim = dynamic_cast<PrimitiveType*>(param->type.get());
+            if (prim && prim->name == "qubit") {
+                // qubits are passed by reference, so the caller's variable is used directly
+                auto arg = dynamic_cast<VariableExpression*>(call->arguments[i].get());
+                if (!arg)
+                    return false;
+                renames[param->name] = arg->name;
+            } else {
+                renames[param->name] = Symbol(prefix + param->name.str());
+            }
+        }
+        auto onStmt = [&](Statement* s) {
+            if (auto var = dynamic_cast<VariableDeclaration*>(s))
+                renames[var->name] = Symbol(prefix + var->name.str());
+        };
+        auto onExpr = [](Expression*) {};
+        walk(fn->body.get(), onStmt, onExpr);
+        ++m_nextId;
+        ++m_inlinedCalls;
+
+        std::vector<std::unique_ptr<Statement>> expansion;
+        for (size_t i = 0; i < fn->params.size(); ++i) {
+            auto& param = fn->params[i];
+            auto prim = dynamic_cast<PrimitiveType*>(param->type.get());
+            if (prim && prim->name == "qubit")
+                continue;
+            auto copy = std::make_unique<VariableDeclaration>();
+            copy->name = renames[param->name];
+            copy->varType = cloneType(param->type.get());
+            copy->initializer = std::move(call->arguments[i]);
+            // unassigned parameters behave as finals, letting constants propagate
+            copy->isFinal = !isAssigned(fn->body.get(), param->name);
+            expansion.push_back(located(std::move(copy), *stmt));
+        }
+        std::unique_ptr<Expression> result;
+        auto& body = fn->body->statements;
+        for (size_t i = 0; i < body.size(); ++i) {
+            auto ret = dynamic_cast<ReturnStatement*>(body[i].get());
+            if (ret && i + 1 == body.size()) {
+                result = cloneExpr(ret->value.get(), renames);
+                break;
+            }
+            expansion.push_back(cloneStmt(body[i].get(), renames));
+        }
+
+        if (wholeStatement) {
+            if (result && !isTrivial(result.get())) {
+                auto exprs = std::make_unique<ExpressionStatement>();
+                exprs->expression = std::move(result);
+                expansion.push_back(located(std::move(exprs), *stmt));
+            }
+            auto block = std::make_unique<BlockStatement>();
+            block->statements = std::move(expansion);
+            out.push_back(located(std::move(block), *stmt));
+            return true;
+        }
+        for (auto& s : expansion) out.push_back(std::move(s));
+        *slot = std::move(result);
+        out.push_back(std::move(stmt));
+        return true;
+    }
+
+    FunctionDeclaration* Inliner::inlineTarget(Expression* e) const {
+        auto call = dynamic_cast<CallExpression*>(e);
+        if (!call)
+            return nullptr;
+        auto var = dynamic_cast<VariableExpression*>(call->callee.get());
+        if (!var || builtInGates.count(var->name))
+            return nullptr;
+        auto it = m_functions.find(var->name);
+        if (it == m_functions.end() || !isInlinable(it->second))
+            return nullptr;
+        return it->second;
+    }
+
+    bool Inliner::isInlinable(FunctionDeclaration* fn) const {
+        if (!fn->body || fn->name == "main" || m_recursive.count(fn->name))
+            return false;
+        for (auto& param : fn->params)
+            if (!dynamic_cast<PrimitiveType*>(param->type.get()))
+                return false;
+
+        // only a trailing top-level return is allowed, and it must exist for value functions
+        size_t statements = 0;
+        size_t returns = 0;
+        auto onStmt = [&](Statement* s) {
+            ++statements;
+            returns += dynamic_cast<ReturnStatement*>(s) != nullptr;
+        };
+        auto onExpr = [](Expression*) {};
+        walk(fn->body.get(), onStmt, onExpr);
+        --statements;  // the body block itself
+        if (statements > m_maxStatements)
+            return false;
+
+        auto& body = fn->body->statements;
+        bool trailingReturn = !body.empty() && dynamic_cast<ReturnStatement*>(body.back().get());
+        if (returns > (trailingReturn ? 1u : 0u))
+            return false;
+        bool isVoid = dynamic_cast<VoidType*>(fn->returnType.get()) != nullptr;
+        if (!isVoid && (!trailingReturn ||
+                        !static_cast<ReturnStatement*>(body.back().get())->value))
+            return false;
+        return true;
+    }
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../ast/ast.hpp"
+
+namespace bloch {
+
+    // Replaces calls to small, non-recursive functions with a copy of the callee's
+    // body. Only calls that form a whole statement (`f(...);`, `T x = f(...);`,
+    // `x = f(...);` or `return f(...);`) are expanded, so evaluation order is kept.
+    // Callee locals are renamed, classical parameters become local copies and
+    // qubit parameters are substituted by the caller's qubit variable.
+    class Inliner {
+       public:
+        static constexpr size_t kDefaultMaxStatements = 8;
+
+        explicit Inliner(size_t maxStatements = kDefaultMaxStatements)
+            : m_maxStatements(maxStatements) {}
+
+        void inlineCalls(Program& program);
+        size_t inlinedCalls() const { return m_inlinedCalls; }
+
+       private:
+        size_t m_maxStatements;
+        size_t m_inlinedCalls = 0;
+        size_t m_nextId = 0;
+        std::unordered_map<Symbol, FunctionDeclaration*> m_functions;
+        std::unordered_map<Symbol, std::unordered_set<Symbol>> m_callGraph;
+        std::unordered_set<Symbol> m_recursive;
+        std::unordered_set<Symbol> m_done;
+
+        void buildCallGraph(Program& program);
+        bool reaches(Symbol from, Symbol target, std::unordered_set<Symbol>& seen) const;
+        void process(FunctionDeclaration* fn);
+        void inlineInto(std::vector<std::unique_ptr<Statement>>& statements);
+        bool expand(std::unique_ptr<Statement>& stmt,
+                    std::vector<std::unique_ptr<Statement>>& out);
+        FunctionDeclaration* inlineTarget(Expression* e) const;
+        bool isInlinable(FunctionDeclaration* fn) const;
+    };
+
+}
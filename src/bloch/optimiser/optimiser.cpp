@@ -0,0 +1,467 @@
+#include "optimiser.hpp"
+#include <climits>
+#include <sstream>
+
+namespace bloch {
+
+    namespace {
+        bool isIntegral(const LiteralExpression* lit) {
+            return lit && (lit->kind == LiteralKind::Int || lit->kind == LiteralKind::Bit);
+        }
+
+        bool constantTruth(const LiteralExpression* lit, bool& truth) {
+            if (isIntegral(lit)) {
+                truth = lit->intValue != 0;
+                return true;
+            }
+            if (lit && lit->kind == LiteralKind::Float) {
+                truth = lit->floatValue != 0.0;
+                return true;
+            }
+            return false;
+        }
+
+        std::unique_ptr<LiteralExpression> makeLiteral(const std::string& value,
+                                                       const std::string& type,
+                                                       const ASTNode& origin) {
+            return std::make_unique<LiteralExpression>(value, type, origin.line, origin.column);
+        }
+    }
+
+    std::string OptimiserStats::summary() const {
+        std::ostringstream out;
+        out << "folded expressions:    " << foldedExpressions << "\n"
+            << "propagated constants:  " << propagatedConstants << "\n"
+            << "removed branches:      " << removedBranches << "\n"
+            << "removed statements:    " << removedStatements << "\n"
+            << "removed variables:     " << removedVariables << "\n";
+        return out.str();
+    }
+
+    void Optimiser::optimise(Program& program) {
+        AstArena::Scope arena(program.arena.get());
+        beginScope();
+        for (auto& fn : program.functions) optimiseFunction(*fn);
+        for (auto& cls : program.classes)
+            for (auto& method : cls->methods) optimiseFunction(*method);
+        optimiseStatements(program.statements);
+        endScope();
+        removeUnusedVariables(program.statements);
+    }
+
+    void Optimiser::optimiseFunction(FunctionDeclaration& fn) {
+        if (!fn.body)
+            return;
+        beginScope();
+        for (auto& param : fn.params) bindConstant(param->name, nullptr);
+        optimiseStatements(fn.body->statements);
+        endScope();
+        removeUnusedVariables(fn.body->statements);
+    }
+
+    void Optimiser::optimiseStatements(std::vector<std::unique_ptr<Statement>>& statements) {
+        size_t kept = 0;
+        for (size_t i = 0; i < statements.size(); ++i) {
+            optimiseStmt(statements[i]);
+            if (!statements[i])
+                continue;
+            bool returns = alwaysReturns(statements[i].get());
+            statements[kept++] = std::move(statements[i]);
+            if (returns) {
+                m_stats.removedStatements += statements.size() - i - 1;
+                break;
+            }
+        }
+        statements.resize(kept);
+    }
+
+    void Optimiser::optimiseStmt(std::unique_ptr<Statement>& s) {
+        if (!s)
+            return;
+        if (auto var = dynamic_cast<VariableDeclaration*>(s.get())) {
+            optimiseExpr(var->initializer);
+            const LiteralExpression* constant = nullptr;
+            auto lit = dynamic_cast<LiteralExpression*>(var->initializer.get());
+            auto prim = dynamic_cast<PrimitiveType*>(var->varType.get());
+            if (var->isFinal && lit && prim) {
+                if (prim->name == "int" && lit->kind == LiteralKind::Int) {
+                    constant = lit;
+                } else if (prim->name == "float" && lit->kind == LiteralKind::Float) {
+                    constant = lit;
+                } else if (prim->name == "bit" && isIntegral(lit) &&
+                           (lit->intValue == 0 || lit->intValue == 1)) {
+                    if (lit->kind != LiteralKind::Bit)
+                        var->initializer = makeLiteral(lit->value, "bit", *lit);
+                    constant = static_cast<LiteralExpression*>(var->initializer.get());
+                }
+            }
+            bindConstant(var->name, constant);
+        } else if (auto block = dynamic_cast<BlockStatement*>(s.get())) {
+            beginScope();
+            optimiseStatements(block->statements);
+            endScope();
+        } else if (auto exprs = dynamic_cast<ExpressionStatement*>(s.get())) {
+            optimiseExpr(exprs->expression);
+        } else if (auto ret = dynamic_cast<ReturnStatement*>(s.get())) {
+            optimiseExpr(ret->value);
+        } else if (auto ifs = dynamic_cast<IfStatement*>(s.get())) {
+            optimiseExpr(ifs->condition);
+            bool truth = false;
+            if (constantTruth(dynamic_cast<LiteralExpression*>(ifs->condition.get()), truth)) {
+                ++m_stats.removedBranches;
+                std::unique_ptr<Statement> taken =
+                    truth ? std::move(ifs->thenBranch) : std::move(ifs->elseBranch);
+                s = std::move(taken);
+                optimiseStmt(s);
+                return;
+            }
+            optimiseStmt(ifs->thenBranch);
+            optimiseStmt(ifs->elseBranch);
+        } else if (auto fors = dynamic_cast<ForStatement*>(s.get())) {
+            beginScope();
+            optimiseStmt(fors->initializer);
+            optimiseExpr(fors->condition);
+            bool truth = true;
+            if (constantTruth(dynamic_cast<LiteralExpression*>(fors->condition.get()), truth) &&
+                !truth) {
+                ++m_stats.removedBranches;
+                endScope();
+                if (!fors->initializer) {
+                    s.reset();
+                    return;
+                }
+                // keep the initializer for its side effects, scoped as the loop was
+                auto block = std::make_unique<BlockStatement>();
+                block->line = fors->line;
+                block->column = fors->column;
+                block->statements.push_back(std::move(fors->initializer));
+                s = std::move(block);
+                return;
+            }
+            optimiseExpr(fors->increment);
+            optimiseStmt(fors->body);
+            endScope();
+        } else if (auto echo = dynamic_cast<EchoStatement*>(s.get())) {
+            optimiseExpr(echo->value);
+        } else if (auto reset = dynamic_cast<ResetStatement*>(s.get())) {
+            optimiseExpr(reset->target);
+        } else if (auto meas = dynamic_cast<MeasureStatement*>(s.get())) {
+            optimiseExpr(meas->qubit);
+        } else if (auto assign = dynamic_cast<AssignmentStatement*>(s.get())) {
+            optimiseExpr(assign->value);
+        }
+    }
+
+    void Optimiser::optimiseExpr(std::unique_ptr<Expression>& e) {
+        if (!e)
+            return;
+        if (auto var = dynamic_cast<VariableExpression*>(e.get())) {
+            if (auto constant = lookupConstant(var->name)) {
+                ++m_stats.propagatedConstants;
+                e = makeLiteral(constant->value, constant->literalType, *var);
+            }
+        } else if (auto paren = dynamic_cast<ParenthesizedExpression*>(e.get())) {
+            optimiseExpr(paren->expression);
+            if (dynamic_cast<LiteralExpression*>(paren->expression.get())) {
+                ++m_stats.foldedExpressions;
+                std::unique_ptr<Expression> inner = std::move(paren->expression);
+                e = std::move(inner);
+            }
+        } else if (auto unary = dynamic_cast<UnaryExpression*>(e.get())) {
+            optimiseExpr(unary->right);
+            foldUnary(e, *unary);
+        } else if (auto bin = dynamic_cast<BinaryExpression*>(e.get())) {
+            optimiseExpr(bin->left);
+            optimiseExpr(bin->right);
+            foldBinary(e, *bin);
+        } else if (auto call = dynamic_cast<CallExpression*>(e.get())) {
+            for (auto& arg : call->arguments) optimiseExpr(arg);
+        } else if (auto idx = dynamic_cast<IndexExpression*>(e.get())) {
+            optimiseExpr(idx->collection);
+            optimiseExpr(idx->index);
+        } else if (auto meas = dynamic_cast<MeasureExpression*>(e.get())) {
+            optimiseExpr(meas->qubit);
+        } else if (auto assign = dynamic_cast<AssignmentExpression*>(e.get())) {
+            optimiseExpr(assign->value);
+        } else if (auto ctor = dynamic_cast<ConstructorCallExpression*>(e.get())) {
+            for (auto& arg : ctor->arguments) optimiseExpr(arg);
+        } else if (auto member = dynamic_cast<MemberAccessExpression*>(e.get())) {
+            optimiseExpr(member->object);
+        }
+    }
+
+    void Optimiser::foldUnary(std::unique_ptr<Expression>& e, UnaryExpression& unary) {
+        auto lit = dynamic_cast<LiteralExpression*>(unary.right.get());
+        if (!lit || unary.op != UnaryOp::Negate)
+            return;
+        if (lit->kind == LiteralKind::Int && lit->intValue != INT_MIN) {
+            ++m_stats.foldedExpressions;
+            e = makeLiteral(std::to_string(-lit->intValue), "int", unary);
+        } else if (lit->kind == LiteralKind::Float) {
+            ++m_stats.foldedExpressions;
+            std::string text =
+                lit->value.front() == '-' ? lit->value.substr(1) : "-" + lit->value;
+            e = makeLiteral(text, "float", unary);
+        }
+    }
+
+    void Optimiser::foldBinary(std::unique_ptr<Expression>& e, BinaryExpression& bin) {
+        auto l = dynamic_cast<LiteralExpression*>(bin.left.get());
+        auto r = dynamic_cast<LiteralExpression*>(bin.right.get());
+        if (!isIntegral(l) || !isIntegral(r))
+            return;
+        long long a = l->intValue;
+        long long b = r->intValue;
+        long long result = 0;
+        bool comparison = false;
+        switch (bin.op) {
+            case BinaryOp::Add:
+                result = a + b;
+                break;
+            case BinaryOp::Subtract:
+                result = a - b;
+                break;
+            case BinaryOp::Multiply:
+                result = a * b;
+                break;
+            case BinaryOp::Divide:
+                if (b == 0)
+                    return;  // leave the runtime error in place
+                result = a / b;
+                break;
+            case BinaryOp::Modulo:
+                if (b == 0)
+                    return;
+                result = a % b;
+                break;
+            case BinaryOp::Greater:
+                result = a > b;
+                comparison = true;
+                break;
+            case BinaryOp::Less:
+                result = a < b;
+                comparison = true;
+                break;
+            case BinaryOp::GreaterEqual:
+                result = a >= b;
+                comparison = true;
+                break;
+            case BinaryOp::LessEqual:
+                result = a <= b;
+                comparison = true;
+                break;
+            case BinaryOp::Equal:
+                result = a == b;
+                comparison = true;
+                break;
+            case BinaryOp::NotEqual:
+                result = a != b;
+                comparison = true;
+                break;
+        }
+        if (result < INT_MIN || result > INT_MAX)
+            return;
+        ++m_stats.foldedExpressions;
+        e = makeLiteral(std::to_string(result), comparison ? "bit" : "int", bin);
+    }
+
+    void Optimiser::beginScope() { m_constants.emplace_back(); }
+
+    void Optimiser::endScope() { m_constants.pop_back(); }
+
+    void Optimiser::bindConstant(Symbol name, const LiteralExpression* value) {
+        if (!m_constants.empty())
+            m_constants.back()[name] = value;
+    }
+
+    const LiteralExpression* Optimiser::lookupConstant(Symbol name) const {
+        for (auto it = m_constants.rbegin(); it != m_constants.rend(); ++it) {
+            auto found = it->find(name);
+            if (found != it->end())
+                return found->second;
+        }
+        return nullptr;
+    }
+
+    void Optimiser::removeUnusedVariables(std::vector<std::unique_ptr<Statement>>& body) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            std::unordered_set<Symbol> reads;
+            std::vector<std::vector<std::unique_ptr<Statement>>*> blocks{&body};
+            for (auto& stmt : body) {
+                collectReads(stmt.get(), reads);
+                collectBlocks(stmt.get(), blocks);
+            }
+
+            // a name is removable only if every declaration of and write to it is pure
+            std::unordered_map<Symbol, bool> removable;
+            for (auto* block : blocks) {
+                for (auto& stmt : *block) {
+                    if (auto var = dynamic_cast<VariableDeclaration*>(stmt.get())) {
+                        if (reads.count(var->name))
+                            continue;
+                        bool pure = isClassicalType(var->varType.get()) &&
+                                    isPure(var->initializer.get());
+                        auto it = removable.find(var->name);
+                        removable[var->name] = pure && (it == removable.end() || it->second);
+                    }
+                }
+            }
+            for (auto* block : blocks) {
+                for (auto& stmt : *block) {
+                    if (auto assign = dynamic_cast<AssignmentStatement*>(stmt.get())) {
+                        auto it = removable.find(assign->name);
+                        if (it != removable.end() && !isPure(assign->value.get()))
+                            it->second = false;
+                    }
+                }
+            }
+
+            for (auto* block : blocks) {
+                size_t kept = 0;
+                for (auto& stmt : *block) {
+                    Symbol name;
+                    bool isDecl = false;
+                    if (auto var = dynamic_cast<VariableDeclaration*>(stmt.get())) {
+                        name = var->name;
+                        isDecl = true;
+                    } else if (auto assign = dynamic_cast<AssignmentStatement*>(stmt.get())) {
+                        name = assign->name;
+                    }
+                    auto it = name.empty() ? removable.end() : removable.find(name);
+                    if (it != removable.end() && it->second) {
+                        changed = true;
+                        if (isDecl)
+                            ++m_stats.removedVariables;
+                        else
+                            ++m_stats.removedStatements;
+                        continue;
+                    }
+                    (*block)[kept++] = std::move(stmt);
+                }
+                block->resize(kept);
+            }
+        }
+    }
+
+    void Optimiser::collectReads(Statement* s, std::unordered_set<Symbol>& reads) {
+        if (!s)
+            return;
+        if (auto var = dynamic_cast<VariableDeclaration*>(s)) {
+            collectReads(var->initializer.get(), reads);
+        } else if (auto block = dynamic_cast<BlockStatement*>(s)) {
+            for (auto& stmt : block->statements) collectReads(stmt.get(), reads);
+        } else if (auto exprs = dynamic_cast<ExpressionStatement*>(s)) {
+            collectReads(exprs->expression.get(), reads);
+        } else if (auto ret = dynamic_cast<ReturnStatement*>(s)) {
+            collectReads(ret->value.get(), reads);
+        } else if (auto ifs = dynamic_cast<IfStatement*>(s)) {
+            collectReads(ifs->condition.get(), reads);
+            collectReads(ifs->thenBranch.get(), reads);
+            collectReads(ifs->elseBranch.get(), reads);
+        } else if (auto fors = dynamic_cast<ForStatement*>(s)) {
+            collectReads(fors->initializer.get(), reads);
+            collectReads(fors->condition.get(), reads);
+            collectReads(fors->increment.get(), reads);
+            collectReads(fors->body.get(), reads);
+        } else if (auto echo = dynamic_cast<EchoStatement*>(s)) {
+            collectReads(echo->value.get(), reads);
+        } else if (auto reset = dynamic_cast<ResetStatement*>(s)) {
+            collectReads(reset->target.get(), reads);
+        } else if (auto meas = dynamic_cast<MeasureStatement*>(s)) {
+            collectReads(meas->qubit.get(), reads);
+        } else if (auto assign = dynamic_cast<AssignmentStatement*>(s)) {
+            collectReads(assign->value.get(), reads);
+        }
+    }
+
+    void Optimiser::collectReads(Expression* e, std::unordered_set<Symbol>& reads) {
+        if (!e)
+            return;
+        if (auto var = dynamic_cast<VariableExpression*>(e)) {
+            reads.insert(var->name);
+        } else if (auto bin = dynamic_cast<BinaryExpression*>(e)) {
+            collectReads(bin->left.get(), reads);
+            collectReads(bin->right.get(), reads);
+        } else if (auto unary = dynamic_cast<UnaryExpression*>(e)) {
+            collectReads(unary->right.get(), reads);
+        } else if (auto paren = dynamic_cast<ParenthesizedExpression*>(e)) {
+            collectReads(paren->expression.get(), reads);
+        } else if (auto call = dynamic_cast<CallExpression*>(e)) {
+            collectReads(call->callee.get(), reads);
+            for (auto& arg : call->arguments) collectReads(arg.get(), reads);
+        } else if (auto idx = dynamic_cast<IndexExpression*>(e)) {
+            collectReads(idx->collection.get(), reads);
+            collectReads(idx->index.get(), reads);
+        } else if (auto meas = dynamic_cast<MeasureExpression*>(e)) {
+            collectReads(meas->qubit.get(), reads);
+        } else if (auto assign = dynamic_cast<AssignmentExpression*>(e)) {
+            // writes inside expressions are kept, so treat the target as live
+            reads.insert(assign->name);
+            collectReads(assign->value.get(), reads);
+        } else if (auto ctor = dynamic_cast<ConstructorCallExpression*>(e)) {
+            for (auto& arg : ctor->arguments) collectReads(arg.get(), reads);
+        } else if (auto member = dynamic_cast<MemberAccessExpression*>(e)) {
+            collectReads(member->object.get(), reads);
+        }
+    }
+
+    void Optimiser::collectBlocks(Statement* s,
+                                  std::vector<std::vector<std::unique_ptr<Statement>>*>& blocks) {
+        if (!s)
+            return;
+        if (auto block = dynamic_cast<BlockStatement*>(s)) {
+            blocks.push_back(&block->statements);
+            for (auto& stmt : block->statements) collectBlocks(stmt.get(), blocks);
+        } else if (auto ifs = dynamic_cast<IfStatement*>(s)) {
+            collectBlocks(ifs->thenBranch.get(), blocks);
+            collectBlocks(ifs->elseBranch.get(), blocks);
+        } else if (auto fors = dynamic_cast<ForStatement*>(s)) {
+            collectBlocks(fors->body.get(), blocks);
+        }
+    }
+
+    bool Optimiser::isPure(Expression* e) {
+        if (!e)
+            return true;
+        if (dynamic_cast<LiteralExpression*>(e) || dynamic_cast<VariableExpression*>(e))
+            return true;
+        if (auto paren = dynamic_cast<ParenthesizedExpression*>(e))
+            return isPure(paren->expression.get());
+        if (auto unary = dynamic_cast<UnaryExpression*>(e))
+            return isPure(unary->right.get());
+        if (auto bin = dynamic_cast<BinaryExpression*>(e)) {
+            if (bin->op == BinaryOp::Divide || bin->op == BinaryOp::Modulo) {
+                // division by zero raises at runtime, so only a non-zero literal is pure
+                auto divisor = dynamic_cast<LiteralExpression*>(bin->right.get());
+                if (!isIntegral(divisor) || divisor->intValue == 0)
+                    return false;
+            }
+            return isPure(bin->left.get()) && isPure(bin->right.get());
+        }
+        return false;
+    }
+
+    bool Optimiser::alwaysReturns(Statement* s) {
+        if (!s)
+            return false;
+        if (dynamic_cast<ReturnStatement*>(s))
+            return true;
+        if (auto block = dynamic_cast<BlockStatement*>(s)) {
+            for (auto& stmt : block->statements)
+                if (alwaysReturns(stmt.get()))
+                    return true;
+            return false;
+        }
+        if (auto ifs = dynamic_cast<IfStatement*>(s))
+            return alwaysReturns(ifs->thenBranch.get()) && alwaysReturns(ifs->elseBranch.get());
+        return false;
+    }
+
+    bool Optimiser::isClassicalType(Type* t) {
+        auto prim = dynamic_cast<PrimitiveType*>(t);
+        return prim && prim->name != "qubit";
+    }
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../ast/ast.hpp"
+
+namespace bloch {
+
+    // Counts of the rewrites performed by a single optimiser run
+    struct OptimiserStats {
+        size_t foldedExpressions = 0;
+        size_t propagatedConstants = 0;
+        size_t removedBranches = 0;
+        size_t removedStatements = 0;
+        size_t removedVariables = 0;
+
+        std::string summary() const;
+    };
+
+    // AST level optimisation pass run after semantic analysis. It folds constant
+    // expressions, propagates `final` values, drops unreachable branches and
+    // statements, and removes classical variables that are never read.
+    class Optimiser {
+       public:
+        void optimise(Program& program);
+        const OptimiserStats& stats() const { return m_stats; }
+
+       private:
+        OptimiserStats m_stats;
+        // nullptr entries mark names that shadow an outer constant
+        std::vector<std::unordered_map<Symbol, const LiteralExpression*>> m_constants;
+
+        void optimiseFunction(FunctionDeclaration& fn);
+        void optimiseStatements(std::vector<std::unique_ptr<Statement>>& statements);
+        void optimiseStmt(std::unique_ptr<Statement>& s);
+        void optimiseExpr(std::unique_ptr<Expression>& e);
+        void foldUnary(std::unique_ptr<Expression>& e, UnaryExpression& unary);
+        void foldBinary(std::unique_ptr<Expression>& e, BinaryExpression& bin);
+
+        void beginScope();
+        void endScope();
+        void bindConstant(Symbol name, const LiteralExpression* value);
+        const LiteralExpression* lookupConstant(Symbol name) const;
+
+        void removeUnusedVariables(std::vector<std::unique_ptr<Statement>>& body);
+        void collectReads(Statement* s, std::unordered_set<Symbol>& reads);
+        void collectReads(Expression* e, std::unordered_set<Symbol>& reads);
+        void collectBlocks(Statement* s,
+                           std::vector<std::vector<std::unique_ptr<Statement>>*>& blocks);
+
+        static bool isPure(Expression* e);
+        static bool alwaysReturns(Statement* s);
+        static bool isClassicalType(Type* t);
+    };
+
+}
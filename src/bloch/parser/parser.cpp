@@ -1,22 +1,41 @@
 #include "parser.hpp"
+#include <algorithm>
+#include <charconv>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <system_error>
 #include "../error/bloch_runtime_error.hpp"
 
 namespace bloch {
-    Parser::Parser(std::vector<Token> tokens) : m_tokens(std::move(tokens)), m_current(0) {}
+    Parser::Parser(std::vector<Token> tokens) : m_tokens(std::move(tokens)) {
+        if (m_tokens.empty())
+            m_tokens.push_back(Token{TokenType::Eof, Symbol(), "", 1, 1});
+        pull();
+        pull();
+    }
 
-    // Token manipulation
-    const Token& Parser::peek() const {
-        if (m_current >= m_tokens.size())
-            return m_tokens.back();
-        return m_tokens[m_current];
+    Parser::Parser(Lexer& lexer) : m_lexer(&lexer) {
+        pull();
+        pull();
     }
-    const Token& Parser::previous() const { return m_tokens[m_current - 1]; }
+
+    // Token manipulation
+    void Parser::pull() {
+        Token& slot = m_window[m_pulled % kWindow];
+        if (m_lexer)
+            slot = m_lexer->next();
+        else
+            slot = m_tokens[std::min(m_pulled, m_tokens.size() - 1)];
+        m_pulled++;
+    }
+    const Token& Parser::peek() const { return m_window[m_current % kWindow]; }
+    const Token& Parser::previous() const { return m_window[(m_current - 1) % kWindow]; }
     const Token& Parser::advance() {
-        if (!isAtEnd())
+        if (!isAtEnd()) {
             m_current++;
+            pull();
+        }
         return previous();
     }
     const Token& Parser::expect(TokenType type, const std::string& message) {
@@ -40,9 +59,9 @@ namespace bloch {
         return peek().type == type;
     }
     bool Parser::checkNext(TokenType type) const {
-        if (m_current + 1 >= m_tokens.size())
+        if (isAtEnd())
             return false;
-        return m_tokens[m_current + 1].type == type;
+        return m_window[(m_current + 1) % kWindow].type == type;
     }
     bool Parser::checkFunctionAnnotation() const {
         if (!check(TokenType::At))
@@ -54,15 +73,47 @@ namespace bloch {
 
     bool Parser::isAtEnd() const { return peek().type == TokenType::Eof; }
 
+    BinaryOp Parser::binaryOpFor(TokenType type) {
+        switch (type) {
+            case TokenType::Plus:
+                return BinaryOp::Add;
+            case TokenType::Minus:
+                return BinaryOp::Subtract;
+            case TokenType::Star:
+                return BinaryOp::Multiply;
+            case TokenType::Slash:
+                return BinaryOp::Divide;
+            case TokenType::Percent:
+                return BinaryOp::Modulo;
+            case TokenType::Greater:
+                return BinaryOp::Greater;
+            case TokenType::Less:
+                return BinaryOp::Less;
+            case TokenType::GreaterEqual:
+                return BinaryOp::GreaterEqual;
+            case TokenType::LessEqual:
+                return BinaryOp::LessEqual;
+            case TokenType::EqualEqual:
+                return BinaryOp::Equal;
+            case TokenType::BangEqual:
+                return BinaryOp::NotEqual;
+            default:
+                reportError("Expected binary operator");
+                return BinaryOp::Add;
+        }
+    }
+
     // Error
-    void Parser::reportError(const std::string& msg) {
-        const Token& token = peek();
+    void Parser::reportError(const std::string& msg) { reportError(peek(), msg); }
+
+    void Parser::reportError(const Token& token, const std::string& msg) {
         throw BlochRuntimeError("Bloch Parser Error", token.line, token.column, msg);
     }
 
     // Main parse function
     std::unique_ptr<Program> Parser::parse() {
         auto program = std::make_unique<Program>();
+        AstArena::Scope arena(program->arena.get());
 
         while (!isAtEnd()) {
             if (check(TokenType::Import)) {
@@ -86,7 +137,7 @@ namespace bloch {
         (void)expect(TokenType::Import, "Expected 'import' keyword");
 
         auto stmt = std::make_unique<ImportStatement>();
-        const Token& moduleToken =
+        Token moduleToken =
             expect(TokenType::Identifier, "Expected module name after 'import'");
         stmt->module = moduleToken.value;
         (void)expect(TokenType::Semicolon, "Expected ';' after import statement");
@@ -102,7 +153,7 @@ namespace bloch {
         while (check(TokenType::At)) {
             (void)advance();
             if (match(TokenType::Quantum) || match(TokenType::Adjoint)) {
-                std::string name = previous().value;
+                std::string name(previous().value);
                 std::string value = "";
                 func->annotations.push_back(
                     std::make_unique<AnnotationNode>(AnnotationNode{name, value}));
@@ -118,17 +169,17 @@ namespace bloch {
         if (match(TokenType::Star)) {
             func->isConstructor = true;
 
-            const Token& nameToken =
+            Token nameToken =
                 expect(TokenType::Identifier, "Expected constructor name after '*'");
-            func->name = nameToken.value;
+            func->name = nameToken.symbol;
             func->line = nameToken.line;
             func->column = nameToken.column;
         } else {
             func->isConstructor = false;
 
-            const Token& nameToken =
+            Token nameToken =
                 expect(TokenType::Identifier, "Expected function name after 'function' keyword");
-            func->name = nameToken.value;
+            func->name = nameToken.symbol;
             func->line = nameToken.line;
             func->column = nameToken.column;
         }
@@ -140,8 +191,8 @@ namespace bloch {
 
             param->type = parseType();
 
-            const Token& paramToken = expect(TokenType::Identifier, "Expected parameter name");
-            param->name = paramToken.value;
+            Token paramToken = expect(TokenType::Identifier, "Expected parameter name");
+            param->name = paramToken.symbol;
             param->line = paramToken.line;
             param->column = paramToken.column;
 
@@ -168,7 +219,7 @@ namespace bloch {
 
         auto clazz = std::make_unique<ClassDeclaration>();
 
-        const Token& nameToken = expect(TokenType::Identifier, "Expected class name after 'class'");
+        Token nameToken = expect(TokenType::Identifier, "Expected class name after 'class'");
         clazz->name = nameToken.value;
 
         (void)expect(TokenType::LBrace, "Expected '{' to start class body");
@@ -180,9 +231,9 @@ namespace bloch {
                 (void)advance();
 
                 (void)expect(TokenType::LParen, "Expected '(' after @members");
-                const Token& modifierToken =
+                Token modifierToken =
                     expect(TokenType::StringLiteral, "Expected access modifier string in @members");
-                std::string accessModifier = modifierToken.value;
+                std::string accessModifier(modifierToken.value);
                 if (accessModifier != "\"public\"" && accessModifier != "\"private\"") {
                     reportError("Access modifier must be \"public\" or \"private\"");
                 }
@@ -241,8 +292,8 @@ namespace bloch {
         if (!check(TokenType::Identifier)) {
             reportError("Expected variable name");
         }
-        const Token& variableToken = advance();
-        var->name = variableToken.value;
+        Token variableToken = advance();
+        var->name = variableToken.symbol;
         var->line = variableToken.line;
         var->column = variableToken.column;
 
@@ -323,7 +374,7 @@ namespace bloch {
 
     // {...}
     std::unique_ptr<BlockStatement> Parser::parseBlock() {
-        const Token& lbrace = expect(TokenType::LBrace, "Expected '{' to start block");
+        Token lbrace = expect(TokenType::LBrace, "Expected '{' to start block");
 
         auto block = std::make_unique<BlockStatement>();
         block->line = lbrace.line;
@@ -352,6 +403,7 @@ namespace bloch {
 
     // if (cond) {...} else {...}
     std::unique_ptr<IfStatement> Parser::parseIf() {
+        Token keyword = previous();
         (void)expect(TokenType::LParen, "Expected '(' after 'if'");
         auto condition = parseExpression();
         (void)expect(TokenType::RParen, "Expected ')' after condition");
@@ -364,6 +416,8 @@ namespace bloch {
         }
 
         auto stmt = std::make_unique<IfStatement>();
+        stmt->line = keyword.line;
+        stmt->column = keyword.column;
         stmt->condition = std::move(condition);
         stmt->thenBranch = std::move(thenBranch);
         stmt->elseBranch = std::move(elseBranch);
@@ -372,6 +426,7 @@ namespace bloch {
 
     // for (init; cond; update) {...}
     std::unique_ptr<ForStatement> Parser::parseFor() {
+        Token keyword = previous();
         (void)expect(TokenType::LParen, "Expected '(' after 'for'");
 
         std::unique_ptr<Statement> initializer = nullptr;
@@ -401,6 +456,8 @@ namespace bloch {
         auto body = parseBlock();
 
         auto stmt = std::make_unique<ForStatement>();
+        stmt->line = keyword.line;
+        stmt->column = keyword.column;
         stmt->initializer = std::move(initializer);
         stmt->condition = std::move(condition);
         stmt->increment = std::move(increment);
@@ -411,12 +468,15 @@ namespace bloch {
 
     // echo(expr);
     std::unique_ptr<EchoStatement> Parser::parseEcho() {
+        Token keyword = previous();
         (void)expect(TokenType::LParen, "Expected '(' after 'echo'");
         auto value = parseExpression();
         (void)expect(TokenType::RParen, "Expected ')' after echo argument");
         (void)expect(TokenType::Semicolon, "Expected ';' after echo statement");
 
         auto stmt = std::make_unique<EchoStatement>();
+        stmt->line = keyword.line;
+        stmt->column = keyword.column;
         stmt->value = std::move(value);
         return stmt;
     }
@@ -424,6 +484,8 @@ namespace bloch {
     // reset q0;
     std::unique_ptr<ResetStatement> Parser::parseReset() {
         auto stmt = std::make_unique<ResetStatement>();
+        stmt->line = previous().line;
+        stmt->column = previous().column;
         stmt->target = parseExpression();
         (void)expect(TokenType::Semicolon, "Expected ';' after reset target");
         return stmt;
@@ -432,6 +494,8 @@ namespace bloch {
     // measure q0;
     std::unique_ptr<MeasureStatement> Parser::parseMeasure() {
         auto stmt = std::make_unique<MeasureStatement>();
+        stmt->line = previous().line;
+        stmt->column = previous().column;
         stmt->qubit = parseExpression();
         (void)expect(TokenType::Semicolon, "Expected ';' after measure target");
         return stmt;
@@ -443,12 +507,11 @@ namespace bloch {
             reportError("Expected variable name in assignment");
         }
 
-        const Token& nameToken = advance();
-        std::string name = nameToken.value;
+        Token nameToken = advance();
         (void)expect(TokenType::Equals, "Expected '=' in assignment");
 
         auto stmt = std::make_unique<AssignmentStatement>();
-        stmt->name = name;
+        stmt->name = nameToken.symbol;
         stmt->line = nameToken.line;
         stmt->column = nameToken.column;
         stmt->value = parseExpression();
@@ -458,9 +521,12 @@ namespace bloch {
     }
 
     std::unique_ptr<ExpressionStatement> Parser::parseExpressionStatement() {
+        Token start = peek();
+        auto stmt = std::make_unique<ExpressionStatement>();
+        stmt->line = start.line;
+        stmt->column = start.column;
         auto expr = parseExpression();
         (void)expect(TokenType::Semicolon, "Expected ';' after expression");
-        auto stmt = std::make_unique<ExpressionStatement>();
         stmt->expression = std::move(expr);
         return stmt;
     }
@@ -477,7 +543,7 @@ namespace bloch {
 
             // Must be a variable on the left-hand side
             if (auto varExpr = dynamic_cast<VariableExpression*>(expr.get())) {
-                std::string name = varExpr->name;
+                Symbol name = varExpr->name;
                 auto value = parseAssignmentExpression();
                 auto assign = std::make_unique<AssignmentExpression>(name, std::move(value));
                 assign->line = equals.line;
@@ -495,7 +561,7 @@ namespace bloch {
         auto expr = parseComparison();
 
         while (match(TokenType::EqualEqual) || match(TokenType::BangEqual)) {
-            std::string op = previous().value;
+            BinaryOp op = binaryOpFor(previous().type);
             auto right = parseComparison();
             expr = std::make_unique<BinaryExpression>(
                 BinaryExpression{op, std::move(expr), std::move(right)});
@@ -509,7 +575,7 @@ namespace bloch {
 
         while (match(TokenType::Greater) || match(TokenType::Less) ||
                match(TokenType::GreaterEqual) || match(TokenType::LessEqual)) {
-            std::string op = previous().value;
+            BinaryOp op = binaryOpFor(previous().type);
             auto right = parseAdditive();
             expr = std::make_unique<BinaryExpression>(
                 BinaryExpression{op, std::move(expr), std::move(right)});
@@ -522,7 +588,7 @@ namespace bloch {
         auto expr = parseMultiplicative();
 
         while (match(TokenType::Plus) || match(TokenType::Minus)) {
-            std::string op = previous().value;
+            BinaryOp op = binaryOpFor(previous().type);
             auto right = parseMultiplicative();
             expr = std::make_unique<BinaryExpression>(
                 BinaryExpression{op, std::move(expr), std::move(right)});
@@ -535,7 +601,7 @@ namespace bloch {
         auto expr = parseUnary();
 
         while (match(TokenType::Star) || match(TokenType::Slash) || match(TokenType::Percent)) {
-            std::string op = previous().value;
+            BinaryOp op = binaryOpFor(previous().type);
             auto right = parseUnary();
             expr = std::make_unique<BinaryExpression>(
                 BinaryExpression{op, std::move(expr), std::move(right)});
@@ -551,13 +617,14 @@ namespace bloch {
             auto args = parseArgumentList();
             (void)expect(TokenType::RParen, "Expected ')' after arguments");
 
-            return std::make_unique<ConstructorCallExpression>(className.value, std::move(args));
+            return std::make_unique<ConstructorCallExpression>(std::string(className.value),
+                                                               std::move(args));
         }
 
         if (match(TokenType::Minus)) {
-            std::string op = previous().value;
             auto right = parseUnary();
-            return std::make_unique<UnaryExpression>(UnaryExpression{op, std::move(right)});
+            return std::make_unique<UnaryExpression>(
+                UnaryExpression{UnaryOp::Negate, std::move(right)});
         }
 
         return parseCall();
@@ -569,7 +636,7 @@ namespace bloch {
         while (true) {
             if (match(TokenType::Dot)) {
                 (void)expect(TokenType::Identifier, "Expected member name after '.'");
-                std::string member = previous().value;
+                std::string member(previous().value);
                 expr = std::make_unique<MemberAccessExpression>(std::move(expr), member);
             } else if (match(TokenType::LParen)) {
                 std::vector<std::unique_ptr<Expression>> args;
@@ -609,7 +676,7 @@ namespace bloch {
                 default:
                     break;
             }
-            return std::make_unique<LiteralExpression>(LiteralExpression{tok.value, litType});
+            return makeLiteral(tok, litType);
         }
 
         if (match(TokenType::Measure)) {
@@ -618,8 +685,8 @@ namespace bloch {
         }
 
         if (match(TokenType::Identifier)) {
-            const Token& token = previous();
-            auto expr = std::make_unique<VariableExpression>(VariableExpression{token.value});
+            Token token = previous();
+            auto expr = std::make_unique<VariableExpression>(token.symbol);
             expr->line = token.line;
             expr->column = token.column;
             return expr;
@@ -636,20 +703,38 @@ namespace bloch {
         return nullptr;
     }
 
+    std::unique_ptr<Expression> Parser::makeLiteral(const Token& token, const std::string& type) {
+        std::string_view text = token.value;
+        std::errc ec{};
+        if (type == "int") {
+            int value;
+            ec = std::from_chars(text.data(), text.data() + text.size(), value).ec;
+        } else if (type == "float") {
+            if (!text.empty() && text.back() == 'f')
+                text.remove_suffix(1);
+            double value;
+            ec = std::from_chars(text.data(), text.data() + text.size(), value).ec;
+        }
+        if (ec == std::errc::result_out_of_range)
+            reportError(token, "Literal " + std::string(token.value) + " is out of range for " +
+                                   type);
+        return std::make_unique<LiteralExpression>(std::string(token.value), type, token.line,
+                                                   token.column);
+    }
+
     // Literals
     std::unique_ptr<Expression> Parser::parseLiteral() {
-        const Token& token = advance();
+        Token token = advance();
 
         switch (token.type) {
             case TokenType::IntegerLiteral:
-                return std::make_unique<LiteralExpression>(LiteralExpression{token.value, "int"});
+                return makeLiteral(token, "int");
             case TokenType::FloatLiteral:
-                return std::make_unique<LiteralExpression>(LiteralExpression{token.value, "float"});
+                return makeLiteral(token, "float");
             case TokenType::CharLiteral:
-                return std::make_unique<LiteralExpression>(LiteralExpression{token.value, "char"});
+                return makeLiteral(token, "char");
             case TokenType::StringLiteral:
-                return std::make_unique<LiteralExpression>(
-                    LiteralExpression{token.value, "string"});
+                return makeLiteral(token, "string");
             default:
                 reportError("Expected a literal value.");
                 return nullptr;
@@ -676,7 +761,7 @@ namespace bloch {
 
         // Handle ObjectType (class types)
         if (check(TokenType::Identifier)) {
-            std::string typeName = advance().value;
+            std::string typeName(advance().value);
             return std::make_unique<ObjectType>(typeName);
         }
 
@@ -696,14 +781,14 @@ namespace bloch {
             if (!check(TokenType::Identifier)) {
                 reportError("Expected code identifier inside logical<>");
             }
-            std::string code = advance().value;
+            std::string code(advance().value);
             (void)expect(TokenType::Greater, "Expected '>' after code identifier");
             return std::make_unique<LogicalType>(code);
         }
 
         if (check(TokenType::Int) || check(TokenType::Float) || check(TokenType::Char) ||
             check(TokenType::String) || check(TokenType::Bit) || check(TokenType::Qubit)) {
-            std::string typeName = advance().value;
+            std::string typeName(advance().value);
             return std::make_unique<PrimitiveType>(typeName);
         }
 
@@ -729,7 +814,7 @@ namespace bloch {
             if (!check(TokenType::Identifier)) {
                 reportError("Expected parameter name.");
             }
-            param->name = advance().value;
+            param->name = advance().symbol;
 
             parameters.push_back(std::move(param));
 
@@ -1,21 +1,35 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <stdexcept>
 #include <vector>
 
 #include "../ast/ast.hpp"
+#include "../lexer/lexer.hpp"
 #include "../lexer/token.hpp"
 
 namespace bloch {
     class Parser {
        public:
         explicit Parser(std::vector<Token> tokens);
+        // Pulls tokens from `lexer` as parsing proceeds, so the whole token
+        // vector is never built. The lexer's source must outlive the parse.
+        explicit Parser(Lexer& lexer);
         [[nodiscard]] std::unique_ptr<Program> parse();
 
        private:
+        // Holds the previous, current and next tokens, indexed by position
+        // modulo the window size. References returned by peek() and advance()
+        // stay valid until the next advance().
+        static constexpr size_t kWindow = 4;
+        std::array<Token, kWindow> m_window{};
+        Lexer* m_lexer = nullptr;
         std::vector<Token> m_tokens;
-        size_t m_current;
+        size_t m_current = 0;
+        size_t m_pulled = 0;
+
+        void pull();
 
         // Token manipulation
         [[nodiscard]] const Token& peek() const;
@@ -31,6 +45,11 @@ namespace bloch {
         [[nodiscard]] bool isAtEnd() const;
 
         void reportError(const std::string& msg);
+        // Reports at `token` rather than at the current token
+        void reportError(const Token& token, const std::string& msg);
+
+        // Operators
+        [[nodiscard]] BinaryOp binaryOpFor(TokenType type);
 
         // Top level
         [[nodiscard]] std::unique_ptr<ImportStatement> parseImport();
@@ -69,6 +88,9 @@ namespace bloch {
 
         // Literals
         [[nodiscard]] std::unique_ptr<Expression> parseLiteral();
+        // Builds the literal for `token`, reporting numbers that do not fit their type
+        [[nodiscard]] std::unique_ptr<Expression> makeLiteral(const Token& token,
+                                                              const std::string& type);
 
         // Types
         [[nodiscard]] std::unique_ptr<Type> parseType();
@@ -0,0 +1,359 @@
+#include "bench_results.hpp"
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace bloch {
+
+    namespace {
+        // Just enough JSON for result files: objects keep their key order
+        struct Json {
+            enum class Kind { Null, Bool, Number, String, Array, Object };
+            Kind kind = Kind::Null;
+            bool boolean = false;
+            double number = 0;
+            std::string string;
+            std::vector<Json> array;
+            std::vector<std::pair<std::string, Json>> object;
+
+            const Json* find(const std::string& key) const {
+                for (auto& [k, v] : object)
+                    if (k == key)
+                        return &v;
+                return nullptr;
+            }
+            std::string stringAt(const std::string& key) const {
+                const Json* v = find(key);
+                return v && v->kind == Kind::String ? v->string : "";
+            }
+        };
+
+        class JsonReader {
+           public:
+            explicit JsonReader(const std::string& text) : m_text(text) {}
+
+            Json read() {
+                Json value = readValue();
+                skipSpace();
+                if (m_pos != m_text.size())
+                    fail("trailing characters");
+                return value;
+            }
+
+           private:
+            const std::string& m_text;
+            size_t m_pos = 0;
+
+            [[noreturn]] void fail(const std::string& what) const {
+                throw std::runtime_error("Invalid benchmark JSON at offset " +
+                                         std::to_string(m_pos) + ": " + what);
+            }
+
+            void skipSpace() {
+                while (m_pos < m_text.size() &&
+                       std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+                    ++m_pos;
+            }
+
+            bool consume(const char* literal) {
+                size_t n = std::char_traits<char>::length(literal);
+                if (m_text.compare(m_pos, n, literal) != 0)
+                    return false;
+                m_pos += n;
+                return true;
+            }
+
+            Json readValue() {
+                skipSpace();
+                if (m_pos >= m_text.size())
+                    fail("unexpected end");
+                Json value;
+                char c = m_text[m_pos];
+                if (c == '{') {
+                    value.kind = Json::Kind::Object;
+                    ++m_pos;
+                    skipSpace();
+                    if (consume("}"))
+                        return value;
+                    do {
+                        skipSpace();
+                        std::string key = readString();
+                        skipSpace();
+                        if (!consume(":"))
+                            fail("expected ':'");
+                        value.object.emplace_back(std::move(key), readValue());
+                        skipSpace();
+                    } while (consume(","));
+                    if (!consume("}"))
+                        fail("expected '}'");
+                } else if (c == '[') {
+                    value.kind = Json::Kind::Array;
+                    ++m_pos;
+                    skipSpace();
+                    if (consume("]"))
+                        return value;
+                    do {
+                        value.array.push_back(readValue());
+                        skipSpace();
+                    } while (consume(","));
+                    if (!consume("]"))
+                        fail("expected ']'");
+                } else if (c == '"') {
+                    value.kind = Json::Kind::String;
+                    value.string = readString();
+                } else if (consume("true")) {
+                    value.kind = Json::Kind::Bool;
+                    value.boolean = true;
+                } else if (consume("false")) {
+                    value.kind = Json::Kind::Bool;
+                } else if (consume("null")) {
+                } else {
+                    const char* start = m_text.c_str() + m_pos;
+                    char* end = nullptr;
+                    value.kind = Json::Kind::Number;
+                    value.number = std::strtod(start, &end);
+                    if (end == start)
+                        fail("unexpected character");
+                    m_pos += static_cast<size_t>(end - start);
+                }
+                return value;
+            }
+
+            std::string readString() {
+                if (!consume("\""))
+                    fail("expected string");
+                std::string out;
+                while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+                    char c = m_text[m_pos++];
+                    if (c != '\\') {
+                        out += c;
+                        continue;
+                    }
+                    if (m_pos >= m_text.size())
+                        break;
+                    char e = m_text[m_pos++];
+                    switch (e) {
+                        case 'n':
+                            out += '\n';
+                            break;
+                        case 't':
+                            out += '\t';
+                            break;
+                        case 'r':
+                            out += '\r';
+                            break;
+                        case 'b':
+                            out += '\b';
+                            break;
+                        case 'f':
+                            out += '\f';
+                            break;
+                        case 'u': {
+                            unsigned code = std::stoul(m_text.substr(m_pos, 4), nullptr, 16);
+                            m_pos += 4;
+                            // names are ASCII in practice; keep the rest as UTF-8
+                            if (code < 0x80) {
+                                out += static_cast<char>(code);
+                            } else if (code < 0x800) {
+                                out += static_cast<char>(0xC0 | (code >> 6));
+                                out += static_cast<char>(0x80 | (code & 0x3F));
+                            } else {
+                                out += static_cast<char>(0xE0 | (code >> 12));
+                                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                                out += static_cast<char>(0x80 | (code & 0x3F));
+                            }
+                            break;
+                        }
+                        default:
+                            out += e;
+                    }
+                }
+                if (!consume("\""))
+                    fail("unterminated string");
+                return out;
+            }
+        };
+
+        std::string escaped(const std::string& s) {
+            std::string out;
+            for (char c : s) {
+                if (c == '"' || c == '\\')
+                    out += '\\';
+                out += c;
+            }
+            return out;
+        }
+
+        // Regularised incomplete beta function I_x(a, b) by continued fraction
+        double incompleteBeta(double x, double a, double b) {
+            if (x <= 0)
+                return 0;
+            if (x >= 1)
+                return 1;
+            if (x > (a + 1) / (a + b + 2))
+                return 1 - incompleteBeta(1 - x, b, a);
+            double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                                    a * std::log(x) + b * std::log(1 - x)) /
+                           a;
+            constexpr double tiny = 1e-300;
+            double f = 1, c = 1, d = 0;
+            for (int i = 0; i <= 400; ++i) {
+                int m = i / 2;
+                double numerator;
+                if (i == 0)
+                    numerator = 1;
+                else if (i % 2 == 0)
+                    numerator = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+                else
+                    numerator = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+                d = 1 + numerator * d;
+                d = 1 / (std::fabs(d) < tiny ? tiny : d);
+                c = 1 + numerator / c;
+                c = std::fabs(c) < tiny ? tiny : c;
+                f *= c * d;
+                if (std::fabs(1 - c * d) < 1e-12)
+                    break;
+            }
+            return front * (f - 1);
+        }
+
+        // t such that the two-sided p-value equals `alpha`
+        double studentTCritical(double alpha, double df) {
+            double lo = 0, hi = 1e4;
+            for (int i = 0; i < 200; ++i) {
+                double mid = (lo + hi) / 2;
+                (studentTPValue(mid, df) > alpha ? lo : hi) = mid;
+            }
+            return (lo + hi) / 2;
+        }
+
+        void meanAndVariance(const std::vector<double>& xs, double& mean, double& variance) {
+            mean = 0;
+            for (double x : xs)
+                mean += x;
+            mean /= static_cast<double>(xs.size());
+            variance = 0;
+            for (double x : xs)
+                variance += (x - mean) * (x - mean);
+            variance = xs.size() > 1 ? variance / static_cast<double>(xs.size() - 1) : 0;
+        }
+    }
+
+    double studentTPValue(double t, double df) {
+        return incompleteBeta(df / (df + t * t), df / 2, 0.5);
+    }
+
+    void BenchmarkResults::add(const std::string& name, const std::string& unit, double sample) {
+        for (auto& series : benchmarks) {
+            if (series.name == name) {
+                series.samples.push_back(sample);
+                return;
+            }
+        }
+        benchmarks.push_back({name, unit, {sample}});
+    }
+
+    const BenchmarkSeries* BenchmarkResults::find(const std::string& name) const {
+        for (auto& series : benchmarks)
+            if (series.name == name)
+                return &series;
+        return nullptr;
+    }
+
+    std::string BenchmarkResults::json() const {
+        std::ostringstream out;
+        out << std::setprecision(10);
+        out << "{\"format\": \"" << kFormat << "\", \"label\": \"" << escaped(label)
+            << "\", \"benchmarks\": [";
+        for (size_t i = 0; i < benchmarks.size(); ++i) {
+            const auto& series = benchmarks[i];
+            out << (i ? ",\n" : "\n") << "{\"name\": \"" << escaped(series.name)
+                << "\", \"unit\": \"" << escaped(series.unit) << "\", \"samples\": [";
+            for (size_t s = 0; s < series.samples.size(); ++s)
+                out << (s ? ", " : "") << series.samples[s];
+            out << "]}";
+        }
+        out << "\n]}\n";
+        return out.str();
+    }
+
+    BenchmarkResults BenchmarkResults::parse(const std::string& text) {
+        Json root = JsonReader(text).read();
+        const Json* list = root.find("benchmarks");
+        if (root.kind != Json::Kind::Object || !list || list->kind != Json::Kind::Array)
+            throw std::runtime_error("Not a benchmark result file: no \"benchmarks\" array");
+        BenchmarkResults results;
+        if (root.find("format")) {
+            if (root.stringAt("format") != kFormat)
+                throw std::runtime_error("Unsupported benchmark format " + root.stringAt("format"));
+            results.label = root.stringAt("label");
+            for (const Json& entry : list->array) {
+                BenchmarkSeries series{entry.stringAt("name"), entry.stringAt("unit"), {}};
+                if (const Json* samples = entry.find("samples"))
+                    for (const Json& s : samples->array)
+                        series.samples.push_back(s.number);
+                results.benchmarks.push_back(std::move(series));
+            }
+            return results;
+        }
+        // Google Benchmark: one entry per repetition, plus aggregates we skip
+        for (const Json& entry : list->array) {
+            if (entry.stringAt("run_type") == "aggregate")
+                continue;
+            std::string name = entry.stringAt("run_name");
+            if (name.empty())
+                name = entry.stringAt("name");
+            const Json* time = entry.find("real_time");
+            if (time)
+                results.add(name, entry.stringAt("time_unit"), time->number);
+        }
+        return results;
+    }
+
+    std::vector<BenchmarkComparison> compareBenchmarks(const BenchmarkResults& base,
+                                                       const BenchmarkResults& current,
+                                                       double confidence) {
+        std::vector<BenchmarkComparison> comparisons;
+        for (const auto& before : base.benchmarks) {
+            const BenchmarkSeries* after = current.find(before.name);
+            if (!after || before.samples.empty() || after->samples.empty())
+                continue;
+            BenchmarkComparison c;
+            c.name = before.name;
+            c.unit = before.unit;
+            double baseVar, newVar;
+            meanAndVariance(before.samples, c.baseMean, baseVar);
+            meanAndVariance(after->samples, c.newMean, newVar);
+            double scale = c.baseMean != 0 ? c.baseMean : 1;
+            double diff = c.newMean - c.baseMean;
+            c.change = c.ciLow = c.ciHigh = diff / scale;
+            auto nb = static_cast<double>(before.samples.size());
+            auto nn = static_cast<double>(after->samples.size());
+            c.testable = nb >= 2 && nn >= 2;
+            if (c.testable) {
+                double vb = baseVar / nb;
+                double vn = newVar / nn;
+                double se = std::sqrt(vb + vn);
+                if (se == 0) {
+                    // identical samples on each side: any difference is exact
+                    c.pValue = diff == 0 ? 1 : 0;
+                } else {
+                    // Welch-Satterthwaite degrees of freedom
+                    double df = (vb + vn) * (vb + vn) /
+                                (vb * vb / (nb - 1) + vn * vn / (nn - 1));
+                    c.pValue = studentTPValue(diff / se, df);
+                    double margin = studentTCritical(1 - confidence, df) * se;
+                    c.ciLow = (diff - margin) / scale;
+                    c.ciHigh = (diff + margin) / scale;
+                }
+            }
+            comparisons.push_back(std::move(c));
+        }
+        return comparisons;
+    }
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace bloch {
+
+    // Repeated measurements of one benchmark metric. Lower is better.
+    struct BenchmarkSeries {
+        std::string name;
+        std::string unit;
+        std::vector<double> samples;
+    };
+
+    // The bloch-bench JSON result format:
+    //   {"format": "bloch-bench-1", "label": "...",
+    //    "benchmarks": [{"name": "...", "unit": "ms", "samples": [1.0, ...]}]}
+    // parse() also accepts Google Benchmark's --benchmark_format=json output,
+    // taking each repetition's real_time as a sample.
+    struct BenchmarkResults {
+        static constexpr const char* kFormat = "bloch-bench-1";
+
+        std::string label;
+        std::vector<BenchmarkSeries> benchmarks;
+
+        // Appends a sample, creating the series on first use
+        void add(const std::string& name, const std::string& unit, double sample);
+        const BenchmarkSeries* find(const std::string& name) const;
+
+        std::string json() const;
+        // Throws std::runtime_error for malformed or unrecognised input
+        static BenchmarkResults parse(const std::string& text);
+    };
+
+    // Change from a baseline to a new series. Changes are relative to the
+    // baseline mean, so +0.05 is 5% slower. The interval and p-value come from
+    // Welch's t-test and need at least two samples on each side.
+    struct BenchmarkComparison {
+        std::string name;
+        std::string unit;
+        double baseMean = 0;
+        double newMean = 0;
+        double change = 0;
+        double ciLow = 0;
+        double ciHigh = 0;
+        double pValue = 1;
+        bool testable = false;
+    };
+
+    // Compares the series present in both results, in the baseline's order
+    std::vector<BenchmarkComparison> compareBenchmarks(const BenchmarkResults& base,
+                                                       const BenchmarkResults& current,
+                                                       double confidence = 0.95);
+
+    // Two-sided p-value of Student's t distribution with `df` degrees of freedom
+    double studentTPValue(double t, double df);
+
+}
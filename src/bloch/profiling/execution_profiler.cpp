@@ -0,0 +1,168 @@
+#include "execution_profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace bloch {
+
+    namespace {
+        double elapsedMs(std::chrono::steady_clock::duration d) {
+            return std::chrono::duration<double, std::milli>(d).count();
+        }
+
+        void writeCounters(std::ostream& out, const ProfileCounters& c) {
+            out << std::setw(12) << c.selfMs << std::setw(10) << c.gates << std::setw(10)
+                << c.measurements << std::setw(10) << c.sweeps << std::setw(14) << c.amplitudes
+                << "\n";
+        }
+    }
+
+    ExecutionProfiler::LineScope::LineScope(ExecutionProfiler* profiler, const Statement* stmt)
+        : m_profiler(profiler) {
+        if (!m_profiler)
+            return;
+        if (m_profiler->m_frames.empty() || dynamic_cast<const BlockStatement*>(stmt))
+            m_profiler = nullptr;
+        else
+            m_previous = m_profiler->enterLine(stmt->line);
+    }
+
+    ExecutionProfiler::LineScope::~LineScope() {
+        if (m_profiler)
+            m_profiler->restoreLine(m_previous);
+    }
+
+    ExecutionProfiler::FunctionScope::FunctionScope(ExecutionProfiler* profiler,
+                                                    const FunctionDeclaration& fn)
+        : m_profiler(profiler) {
+        if (m_profiler)
+            m_profiler->enterFunction(fn);
+    }
+
+    ExecutionProfiler::FunctionScope::~FunctionScope() {
+        if (m_profiler)
+            m_profiler->exitFunction();
+    }
+
+    void ExecutionProfiler::charge(Clock::time_point now) {
+        if (!m_frames.empty()) {
+            Frame& frame = m_frames.back();
+            double ms = elapsedMs(now - m_last);
+            frame.line->selfMs += ms;
+            frame.function->counters.selfMs += ms;
+            *frame.stack += ms;
+        }
+        m_last = now;
+    }
+
+    int ExecutionProfiler::enterLine(int line) {
+        charge(Clock::now());
+        Frame& frame = m_frames.back();
+        int previous = frame.lineNumber;
+        frame.lineNumber = line;
+        frame.line = &m_lines[{*frame.name, line}];
+        ++frame.line->hits;
+        return previous;
+    }
+
+    void ExecutionProfiler::restoreLine(int line) {
+        charge(Clock::now());
+        Frame& frame = m_frames.back();
+        frame.lineNumber = line;
+        frame.line = &m_lines[{*frame.name, line}];
+    }
+
+    void ExecutionProfiler::enterFunction(const FunctionDeclaration& fn) {
+        Clock::time_point now = Clock::now();
+        charge(now);
+        Frame frame;
+        frame.name = &fn.name.str();
+        frame.function = &m_functions[fn.name];
+        frame.path = m_frames.empty() ? fn.name.str() : m_frames.back().path + ";" + fn.name.str();
+        frame.stack = &m_stacks[frame.path];
+        frame.lineNumber = fn.line;
+        frame.line = &m_lines[{fn.name, fn.line}];
+        frame.outermost = std::none_of(m_frames.begin(), m_frames.end(),
+                                       [&](const Frame& f) { return *f.name == fn.name; });
+        frame.entered = now;
+        // calls are counted as hits on the function itself, statements on its lines
+        ++frame.function->counters.hits;
+        m_frames.push_back(std::move(frame));
+    }
+
+    void ExecutionProfiler::exitFunction() {
+        Clock::time_point now = Clock::now();
+        charge(now);
+        const Frame& frame = m_frames.back();
+        if (frame.outermost)
+            frame.function->totalMs += elapsedMs(now - frame.entered);
+        m_frames.pop_back();
+    }
+
+    void ExecutionProfiler::quantumOp(uint64_t gates, uint64_t measurements, uint64_t sweeps,
+                                      size_t stateSize) {
+        if (m_frames.empty())
+            return;
+        Frame& frame = m_frames.back();
+        for (ProfileCounters* c : {frame.line, &frame.function->counters}) {
+            c->gates += gates;
+            c->measurements += measurements;
+            c->sweeps += sweeps;
+            c->amplitudes += sweeps * stateSize;
+        }
+    }
+
+    std::string ExecutionProfiler::report() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+
+        std::vector<const std::pair<const std::string, FunctionProfile>*> functions;
+        for (auto& entry : m_functions)
+            functions.push_back(&entry);
+        std::stable_sort(functions.begin(), functions.end(), [](auto* a, auto* b) {
+            return a->second.counters.selfMs > b->second.counters.selfMs;
+        });
+        out << std::left << std::setw(24) << "function" << std::right << std::setw(10) << "calls"
+            << std::setw(12) << "total ms" << std::setw(12) << "self ms" << std::setw(10)
+            << "gates" << std::setw(10) << "measure" << std::setw(10) << "sweeps" << std::setw(14)
+            << "amplitudes" << "\n";
+        for (auto* entry : functions) {
+            const FunctionProfile& fn = entry->second;
+            out << std::left << std::setw(24) << entry->first << std::right << std::setw(10)
+                << fn.counters.hits << std::setw(12) << fn.totalMs;
+            writeCounters(out, fn.counters);
+        }
+
+        std::vector<const std::pair<const std::pair<std::string, int>, ProfileCounters>*> lines;
+        for (auto& entry : m_lines)
+            if (entry.second.hits || entry.second.selfMs > 0)
+                lines.push_back(&entry);
+        std::stable_sort(lines.begin(), lines.end(), [](auto* a, auto* b) {
+            return a->second.selfMs > b->second.selfMs;
+        });
+        out << "\n"
+            << std::left << std::setw(24) << "line" << std::right << std::setw(10) << "hits"
+            << std::setw(12) << "" << std::setw(12) << "self ms" << std::setw(10) << "gates"
+            << std::setw(10) << "measure" << std::setw(10) << "sweeps" << std::setw(14)
+            << "amplitudes" << "\n";
+        for (auto* entry : lines) {
+            std::string where = entry->first.first + ":" + std::to_string(entry->first.second);
+            out << std::left << std::setw(24) << where << std::right << std::setw(10)
+                << entry->second.hits << std::setw(12) << "";
+            writeCounters(out, entry->second);
+        }
+        return out.str();
+    }
+
+    std::string ExecutionProfiler::collapsedStacks() const {
+        std::ostringstream out;
+        for (auto& [path, ms] : m_stacks) {
+            auto us = static_cast<long long>(std::llround(ms * 1000.0));
+            if (us > 0)
+                out << path << " " << us << "\n";
+        }
+        return out.str();
+    }
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../ast/ast.hpp"
+
+namespace bloch {
+
+    // Work attributed to a function or source line. Time is self time: the
+    // time spent on that line or in that function, excluding callees.
+    struct ProfileCounters {
+        uint64_t hits = 0;
+        double selfMs = 0;
+        uint64_t gates = 0;
+        uint64_t measurements = 0;
+        // full passes over the state vector and the amplitudes they touched
+        uint64_t sweeps = 0;
+        uint64_t amplitudes = 0;
+    };
+
+    struct FunctionProfile {
+        ProfileCounters counters;
+        // inclusive time, counting recursive calls once
+        double totalMs = 0;
+    };
+
+    // Attributes the time and quantum work of an interpreted run to functions,
+    // source lines and call stacks. The RuntimeEvaluator reports statements and
+    // calls through the scopes below; time between two events is charged to the
+    // line that was current, so attribution is exact rather than sampled.
+    class ExecutionProfiler {
+       public:
+        // Makes a statement's line current while it executes. Blocks and a null
+        // profiler are ignored, so the evaluator can construct one unconditionally.
+        class LineScope {
+           public:
+            LineScope(ExecutionProfiler* profiler, const Statement* stmt);
+            ~LineScope();
+            LineScope(const LineScope&) = delete;
+            LineScope& operator=(const LineScope&) = delete;
+
+           private:
+            ExecutionProfiler* m_profiler;
+            int m_previous = 0;
+        };
+
+        class FunctionScope {
+           public:
+            FunctionScope(ExecutionProfiler* profiler, const FunctionDeclaration& fn);
+            ~FunctionScope();
+            FunctionScope(const FunctionScope&) = delete;
+            FunctionScope& operator=(const FunctionScope&) = delete;
+
+           private:
+            ExecutionProfiler* m_profiler;
+        };
+
+        // Quantum work at the current line; `stateSize` is the number of amplitudes
+        void gate(size_t stateSize) { quantumOp(1, 0, 1, stateSize); }
+        void measurement(size_t stateSize) { quantumOp(0, 1, 2, stateSize); }
+        void allocation(size_t stateSize) { quantumOp(0, 0, 1, stateSize); }
+
+        const std::map<std::string, FunctionProfile>& functions() const { return m_functions; }
+        const std::map<std::pair<std::string, int>, ProfileCounters>& lines() const {
+            return m_lines;
+        }
+        // Self time in milliseconds per call stack, e.g. "main;bell"
+        const std::map<std::string, double>& stacks() const { return m_stacks; }
+
+        // Functions and lines sorted by self time
+        std::string report() const;
+        // One "main;callee <microseconds>" line per stack, as read by flame graph tools
+        std::string collapsedStacks() const;
+
+       private:
+        using Clock = std::chrono::steady_clock;
+        struct Frame {
+            const std::string* name;
+            FunctionProfile* function;
+            double* stack;
+            std::string path;
+            ProfileCounters* line;
+            int lineNumber;
+            bool outermost;
+            Clock::time_point entered;
+        };
+        std::vector<Frame> m_frames;
+        Clock::time_point m_last;
+        std::map<std::string, FunctionProfile> m_functions;
+        std::map<std::pair<std::string, int>, ProfileCounters> m_lines;
+        std::map<std::string, double> m_stacks;
+
+        void charge(Clock::time_point now);
+        int enterLine(int line);
+        void restoreLine(int line);
+        void enterFunction(const FunctionDeclaration& fn);
+        void exitFunction();
+        void quantumOp(uint64_t gates, uint64_t measurements, uint64_t sweeps, size_t stateSize);
+    };
+
+}
@@ -0,0 +1,82 @@
+#include "phase_timer.hpp"
+#include <sys/resource.h>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace bloch {
+
+    namespace {
+        double cpuMs(const rusage& usage) {
+            auto ms = [](const timeval& t) { return t.tv_sec * 1000.0 + t.tv_usec / 1000.0; };
+            return ms(usage.ru_utime) + ms(usage.ru_stime);
+        }
+
+        rusage usageOf(int who) {
+            rusage usage{};
+            getrusage(who, &usage);
+            return usage;
+        }
+    }
+
+    PhaseTimer::Scope::Scope(PhaseTimer& timer, std::string name)
+        : m_timer(timer),
+          m_name(std::move(name)),
+          m_wallStart(std::chrono::steady_clock::now()),
+          m_cpuStart(cpuMs(usageOf(RUSAGE_SELF))),
+          m_childCpuStart(cpuMs(usageOf(RUSAGE_CHILDREN))) {}
+
+    PhaseTimer::Scope::~Scope() {
+        auto end = std::chrono::steady_clock::now();
+        auto wall = end - m_wallStart;
+        rusage self = usageOf(RUSAGE_SELF);
+        rusage children = usageOf(RUSAGE_CHILDREN);
+        PhaseTiming timing;
+        timing.name = std::move(m_name);
+        timing.wallMs = std::chrono::duration<double, std::milli>(wall).count();
+        double childCpu = cpuMs(children) - m_childCpuStart;
+        timing.cpuMs = cpuMs(self) - m_cpuStart + childCpu;
+        timing.peakRssKb = self.ru_maxrss;
+        if (childCpu > 0)
+            timing.childPeakRssKb = children.ru_maxrss;
+        if (m_timer.m_trace)
+            m_timer.m_trace->record(TraceCategory::Phase, timing.name, m_wallStart, end);
+        m_timer.m_phases.push_back(std::move(timing));
+    }
+
+    std::string PhaseTimer::text() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << std::left << std::setw(12) << "phase" << std::right << std::setw(12) << "wall ms"
+            << std::setw(12) << "cpu ms" << std::setw(14) << "peak rss kb" << std::setw(16)
+            << "child rss kb" << "\n";
+        double wall = 0;
+        double cpu = 0;
+        for (auto& phase : m_phases) {
+            out << std::left << std::setw(12) << phase.name << std::right << std::setw(12)
+                << phase.wallMs << std::setw(12) << phase.cpuMs << std::setw(14)
+                << phase.peakRssKb << std::setw(16) << phase.childPeakRssKb << "\n";
+            wall += phase.wallMs;
+            cpu += phase.cpuMs;
+        }
+        out << std::left << std::setw(12) << "total" << std::right << std::setw(12) << wall
+            << std::setw(12) << cpu << "\n";
+        return out.str();
+    }
+
+    std::string PhaseTimer::json() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "{\"phases\": [";
+        for (size_t i = 0; i < m_phases.size(); ++i) {
+            const auto& phase = m_phases[i];
+            out << (i ? ", " : "") << "{\"name\": \"" << phase.name
+                << "\", \"wall_ms\": " << phase.wallMs << ", \"cpu_ms\": " << phase.cpuMs
+                << ", \"peak_rss_kb\": " << phase.peakRssKb
+                << ", \"child_peak_rss_kb\": " << phase.childPeakRssKb << "}";
+        }
+        out << "]}\n";
+        return out.str();
+    }
+
+}
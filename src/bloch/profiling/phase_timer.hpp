@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+#include "trace_recorder.hpp"
+
+namespace bloch {
+
+    // Resources used by one compiler phase. CPU time includes child processes
+    // such as the external C++ compiler. Peak RSS is the process high-water mark
+    // when the phase ended; childPeakRssKb is the largest child process seen so
+    // far, reported only for phases that waited on one.
+    struct PhaseTiming {
+        std::string name;
+        double wallMs = 0;
+        double cpuMs = 0;
+        long peakRssKb = 0;
+        long childPeakRssKb = 0;
+    };
+
+    class PhaseTimer {
+       public:
+        // Records the enclosing block as a phase
+        class Scope {
+           public:
+            Scope(PhaseTimer& timer, std::string name);
+            ~Scope();
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+           private:
+            PhaseTimer& m_timer;
+            std::string m_name;
+            std::chrono::steady_clock::time_point m_wallStart;
+            double m_cpuStart;
+            double m_childCpuStart;
+        };
+
+        template <typename F>
+        decltype(auto) measure(std::string name, F&& fn) {
+            Scope scope(*this, std::move(name));
+            return fn();
+        }
+
+        // Also records each phase as a span in `trace` when non-null
+        void setTrace(TraceRecorder* trace) { m_trace = trace; }
+
+        const std::vector<PhaseTiming>& phases() const { return m_phases; }
+        std::string text() const;
+        std::string json() const;
+
+       private:
+        std::vector<PhaseTiming> m_phases;
+        TraceRecorder* m_trace = nullptr;
+    };
+
+}
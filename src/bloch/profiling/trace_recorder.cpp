@@ -0,0 +1,98 @@
+#include "trace_recorder.hpp"
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace bloch {
+
+    namespace {
+        const char* categoryName(size_t category) {
+            static const char* names[] = {"phase", "call", "gate", "measure"};
+            return names[category];
+        }
+
+        std::string escaped(const std::string& s) {
+            std::string out;
+            for (char c : s) {
+                if (c == '"' || c == '\\')
+                    out += '\\';
+                out += c;
+            }
+            return out;
+        }
+    }
+
+    TraceRecorder::TraceRecorder(size_t maxEventsPerCategory)
+        : m_maxEvents(maxEventsPerCategory < 2 ? 2 : maxEventsPerCategory),
+          m_origin(Clock::now()) {}
+
+    void TraceRecorder::record(TraceCategory category, const std::string& name,
+                               Clock::time_point start, Clock::time_point end) {
+        auto index = static_cast<size_t>(category);
+        double startUs = std::chrono::duration<double, std::micro>(start - m_origin).count();
+        double durationUs = std::chrono::duration<double, std::micro>(end - start).count();
+        Total& total = m_totals[index][name];
+        ++total.count;
+        total.durationUs += durationUs;
+
+        Stream& stream = m_streams[index];
+        if (stream.seen++ % stream.stride != 0)
+            return;
+        stream.events.push_back({name, startUs, durationUs});
+        if (stream.events.size() < m_maxEvents)
+            return;
+        // keep the spans whose sequence number is a multiple of the doubled stride
+        size_t keep = 0;
+        for (size_t i = 0; i < stream.events.size(); i += 2)
+            stream.events[keep++] = std::move(stream.events[i]);
+        stream.events.resize(keep);
+        stream.stride *= 2;
+    }
+
+    uint64_t TraceRecorder::seen(TraceCategory category) const {
+        return m_streams[static_cast<size_t>(category)].seen;
+    }
+
+    size_t TraceRecorder::kept(TraceCategory category) const {
+        return m_streams[static_cast<size_t>(category)].events.size();
+    }
+
+    uint64_t TraceRecorder::stride(TraceCategory category) const {
+        return m_streams[static_cast<size_t>(category)].stride;
+    }
+
+    std::string TraceRecorder::json() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\": [";
+        bool first = true;
+        for (size_t c = 0; c < m_streams.size(); ++c) {
+            for (const Event& e : m_streams[c].events) {
+                out << (first ? "\n" : ",\n") << "{\"name\": \"" << escaped(e.name)
+                    << "\", \"cat\": \"" << categoryName(c) << "\", \"ph\": \"X\", \"ts\": "
+                    << e.startUs << ", \"dur\": " << e.durationUs << ", \"pid\": 1, \"tid\": 1}";
+                first = false;
+            }
+        }
+        out << "\n],\n\"displayTimeUnit\": \"ms\",\n\"otherData\": {";
+        for (size_t c = 0; c < m_streams.size(); ++c) {
+            const Stream& stream = m_streams[c];
+            out << (c ? ",\n" : "\n") << "\"" << categoryName(c) << "\": {\"seen\": " << stream.seen
+                << ", \"kept\": " << stream.events.size() << ", \"stride\": " << stream.stride
+                << ", \"totals\": {";
+            // sorted so the output is stable
+            std::map<std::string, Total> totals(m_totals[c].begin(), m_totals[c].end());
+            bool firstTotal = true;
+            for (auto& [name, total] : totals) {
+                out << (firstTotal ? "" : ", ") << "\"" << escaped(name)
+                    << "\": {\"count\": " << total.count << ", \"total_us\": " << total.durationUs
+                    << "}";
+                firstTotal = false;
+            }
+            out << "}}";
+        }
+        out << "\n}}\n";
+        return out.str();
+    }
+
+}
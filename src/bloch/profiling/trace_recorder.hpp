@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../lexer/symbol.hpp"
+
+namespace bloch {
+
+    enum class TraceCategory { Phase, Call, Gate, Measure };
+
+    // Collects spans for a Chrome Trace Event Format timeline. Each category
+    // keeps at most `maxEventsPerCategory` spans: when a category fills up,
+    // every other stored span is dropped and only every 2^k-th later span is
+    // kept, so a multi-million-gate run yields an evenly spaced sample. Counts
+    // and total durations per span name are always exact.
+    class TraceRecorder {
+       public:
+        using Clock = std::chrono::steady_clock;
+        static constexpr size_t kDefaultMaxEvents = 100000;
+
+        explicit TraceRecorder(size_t maxEventsPerCategory = kDefaultMaxEvents);
+
+        // Records the enclosing block; does nothing for a null recorder. Names
+        // are interned symbols, so the span never outlives its name.
+        class Span {
+           public:
+            Span(TraceRecorder* recorder, TraceCategory category, Symbol name)
+                : m_recorder(recorder), m_category(category), m_name(name) {
+                if (m_recorder)
+                    m_start = Clock::now();
+            }
+            ~Span() {
+                if (m_recorder)
+                    m_recorder->record(m_category, m_name.str(), m_start, Clock::now());
+            }
+            Span(const Span&) = delete;
+            Span& operator=(const Span&) = delete;
+
+           private:
+            TraceRecorder* m_recorder;
+            TraceCategory m_category;
+            Symbol m_name;
+            Clock::time_point m_start;
+        };
+
+        void record(TraceCategory category, const std::string& name, Clock::time_point start,
+                    Clock::time_point end);
+
+        // Spans seen and kept for a category, and the current sampling stride
+        uint64_t seen(TraceCategory category) const;
+        size_t kept(TraceCategory category) const;
+        uint64_t stride(TraceCategory category) const;
+
+        std::string json() const;
+
+       private:
+        struct Event {
+            std::string name;
+            double startUs;
+            double durationUs;
+        };
+        struct Stream {
+            std::vector<Event> events;
+            uint64_t seen = 0;
+            uint64_t stride = 1;
+        };
+        struct Total {
+            uint64_t count = 0;
+            double durationUs = 0;
+        };
+        size_t m_maxEvents;
+        Clock::time_point m_origin;
+        std::array<Stream, 4> m_streams;
+        std::array<std::unordered_map<std::string, Total>, 4> m_totals;
+    };
+
+}
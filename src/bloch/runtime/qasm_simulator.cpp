@@ -1,21 +1,16 @@
 #include "qasm_simulator.hpp"
 #include <array>
 #include <cmath>
-#include <random>
 #include <sstream>
+#include "random.hpp"
 
 namespace bloch {
 
-    static std::mt19937 rng{std::random_device{}()};
-
     int QasmSimulator::allocateQubit() {
+        // the new qubit becomes the highest index bit, so existing amplitudes keep
+        // their positions and the upper half starts out as |0>
         int index = m_qubits++;
-        std::vector<std::complex<double>> newState(m_state.size() * 2);
-        for (size_t i = 0; i < m_state.size(); ++i) {
-            newState[2 * i] = m_state[i];
-            newState[2 * i + 1] = 0;
-        }
-        m_state.swap(newState);
+        m_state.resize(m_state.size() * 2);
         return index;
     }
 
@@ -38,26 +33,30 @@ namespace bloch {
         const std::array<std::complex<double>, 4> m{1 / std::sqrt(2.0), 1 / std::sqrt(2.0),
                                                     1 / std::sqrt(2.0), -1 / std::sqrt(2.0)};
         applySingleQubitGate(q, m);
-        m_ops += "h q[" + std::to_string(q) + "];\n";
+        if (m_recordOps)
+            m_ops += "h q[" + std::to_string(q) + "];\n";
     }
 
     void QasmSimulator::x(int q) {
         const std::array<std::complex<double>, 4> m{0, 1, 1, 0};
         applySingleQubitGate(q, m);
-        m_ops += "x q[" + std::to_string(q) + "];\n";
+        if (m_recordOps)
+            m_ops += "x q[" + std::to_string(q) + "];\n";
     }
 
     void QasmSimulator::y(int q) {
         const std::array<std::complex<double>, 4> m{0.0, std::complex<double>(0, -1),
                                                     std::complex<double>(0, 1), 0.0};
         applySingleQubitGate(q, m);
-        m_ops += "y q[" + std::to_string(q) + "];\n";
+        if (m_recordOps)
+            m_ops += "y q[" + std::to_string(q) + "];\n";
     }
 
     void QasmSimulator::z(int q) {
         const std::array<std::complex<double>, 4> m{1.0, 0.0, 0.0, -1.0};
         applySingleQubitGate(q, m);
-        m_ops += "z q[" + std::to_string(q) + "];\n";
+        if (m_recordOps)
+            m_ops += "z q[" + std::to_string(q) + "];\n";
     }
 
     void QasmSimulator::rx(int q, double t) {
@@ -66,7 +65,8 @@ namespace bloch {
         const std::array<std::complex<double>, 4> m{ct, std::complex<double>(0, -st),
                                                     std::complex<double>(0, -st), ct};
         applySingleQubitGate(q, m);
-        m_ops += "rx(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n";
+        if (m_recordOps)
+            m_ops += "rx(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n";
     }
 
     void QasmSimulator::ry(int q, double t) {
@@ -74,7 +74,8 @@ namespace bloch {
         double st = std::sin(t / 2);
         const std::array<std::complex<double>, 4> m{ct, -st, st, ct};
         applySingleQubitGate(q, m);
-        m_ops += "ry(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n";
+        if (m_recordOps)
+            m_ops += "ry(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n";
     }
 
     void QasmSimulator::rz(int q, double t) {
@@ -82,7 +83,8 @@ namespace bloch {
         std::complex<double> eneg = std::exp(std::complex<double>(0, t / 2));
         const std::array<std::complex<double>, 4> m{epos, 0.0, 0.0, eneg};
         applySingleQubitGate(q, m);
-        m_ops += "rz(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n";
+        if (m_recordOps)
+            m_ops += "rz(" + std::to_string(t) + ") q[" + std::to_string(q) + "];\n";
     }
 
     void QasmSimulator::cx(int control, int target) {
@@ -94,7 +96,8 @@ namespace bloch {
                 std::swap(m_state[i], m_state[j]);
             }
         }
-        m_ops += "cx q[" + std::to_string(control) + "],q[" + std::to_string(target) + "];\n";
+        if (m_recordOps)
+            m_ops += "cx q[" + std::to_string(control) + "],q[" + std::to_string(target) + "];\n";
     }
 
     int QasmSimulator::measure(int q) {
@@ -103,8 +106,7 @@ namespace bloch {
         for (size_t i = 0; i < m_state.size(); ++i)
             if (i & bit)
                 p1 += std::norm(m_state[i]);
-        std::uniform_real_distribution<double> dist(0.0, 1.0);
-        double r = dist(rng);
+        double r = sampleUniform();
         int res = r < p1 ? 1 : 0;
         double norm = std::sqrt(res ? p1 : 1 - p1);
         for (size_t i = 0; i < m_state.size(); ++i) {
@@ -113,7 +115,8 @@ namespace bloch {
             else
                 m_state[i] /= norm;
         }
-        m_ops += "measure q[" + std::to_string(q) + "] -> c[" + std::to_string(q) + "];\n";
+        if (m_recordOps)
+            m_ops += "measure q[" + std::to_string(q) + "] -> c[" + std::to_string(q) + "];\n";
         return res;
     }
 
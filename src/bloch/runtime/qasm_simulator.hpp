@@ -9,6 +9,9 @@ namespace bloch {
 
     class QasmSimulator {
        public:
+        // Recording can be turned off when the QASM text is not needed
+        explicit QasmSimulator(bool recordOps = true) : m_recordOps(recordOps) {}
+
         int allocateQubit();
         void h(int q);
         void x(int q);
@@ -20,11 +23,14 @@ namespace bloch {
         void cx(int control, int target);
         int measure(int q);
         std::string getQasm() const;
+        // Number of amplitudes, i.e. the work done by one sweep of the state vector
+        size_t stateSize() const { return m_state.size(); }
 
        private:
         int m_qubits = 0;
-        std::vector<std::complex<double>> m_state{1, 0};
+        std::vector<std::complex<double>> m_state{1.0};
         std::string m_ops;
+        bool m_recordOps;
 
         void applySingleQubitGate(int q, const std::array<std::complex<double>, 4>& m);
     };
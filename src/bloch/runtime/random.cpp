@@ -0,0 +1,12 @@
+#include "random.hpp"
+#include <random>
+
+namespace bloch {
+
+    double sampleUniform() {
+        static std::mt19937 rng{std::random_device{}()};
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        return dist(rng);
+    }
+
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace bloch {
+
+    // Uniform sample in [0, 1) from the generator shared by all simulators
+    double sampleUniform();
+
+}
@@ -1,85 +1,151 @@
 #include "runtime_evaluator.hpp"
+#include <array>
 #include "../error/bloch_runtime_error.hpp"
 #include "../semantics/built_ins.hpp"
 
 namespace bloch {
 
+    namespace {
+        constexpr size_t kInitialBindings = 256;
+        constexpr size_t kInitialScopes = 64;
+        constexpr size_t kInitialFrames = 32;
+        const Symbol kMeasureSpan("measure");
+        const Symbol kMain("main");
+        const Symbol kH("h"), kX("x"), kY("y"), kZ("z");
+        const Symbol kRx("rx"), kRy("ry"), kRz("rz"), kCx("cx");
+    }
+
+    RuntimeEvaluator::RuntimeEvaluator(std::ostream& out) : m_out(out) {
+        m_bindings.reserve(kInitialBindings);
+        m_scopes.reserve(kInitialScopes);
+        m_frames.reserve(kInitialFrames);
+    }
+
     void RuntimeEvaluator::execute(Program& program) {
         for (auto& fn : program.functions) {
-            m_functions[fn->name] = fn.get();
+            if (m_functions.size() <= fn->name.id())
+                m_functions.resize(fn->name.id() + 1);
+            m_functions[fn->name.id()] = fn.get();
         }
         // assume main exists
-        auto it = m_functions.find("main");
-        if (it != m_functions.end()) {
-            call(it->second, {});
-        }
+        if (FunctionDeclaration* entry = function(kMain))
+            call(entry, m_bindings.size());
+    }
+
+    void RuntimeEvaluator::beginScope() { m_scopes.push_back(m_bindings.size()); }
+
+    void RuntimeEvaluator::endScope() {
+        m_bindings.resize(m_scopes.back());
+        m_scopes.pop_back();
+    }
+
+    FunctionDeclaration* RuntimeEvaluator::function(Symbol name) const {
+        return name.id() < m_functions.size() ? m_functions[name.id()] : nullptr;
     }
 
-    Value RuntimeEvaluator::lookup(const std::string& name) {
-        for (auto it = m_env.rbegin(); it != m_env.rend(); ++it) {
-            auto fit = it->find(name);
-            if (fit != it->end())
-                return fit->second;
+    void RuntimeEvaluator::declare(Symbol name, Value v) { m_bindings.push_back({name, v}); }
+
+    Value RuntimeEvaluator::lookup(Symbol name) const {
+        size_t base = m_frames.empty() ? 0 : m_frames.back();
+        for (size_t i = m_bindings.size(); i > base; --i) {
+            const Binding& b = m_bindings[i - 1];
+            if (b.name == name)
+                return b.value;
         }
         return {};
     }
 
-    void RuntimeEvaluator::assign(const std::string& name, const Value& v) {
-        for (auto it = m_env.rbegin(); it != m_env.rend(); ++it) {
-            auto fit = it->find(name);
-            if (fit != it->end()) {
-                fit->second = v;
+    void RuntimeEvaluator::assign(Symbol name, Value v) {
+        size_t base = m_frames.empty() ? 0 : m_frames.back();
+        for (size_t i = m_bindings.size(); i > base; --i) {
+            Binding& b = m_bindings[i - 1];
+            if (b.name == name) {
+                b.value = v.convertTo(b.value.type());
                 return;
             }
         }
-        m_env.back()[name] = v;
+        declare(name, v);
     }
 
-    Value RuntimeEvaluator::call(FunctionDeclaration* fn, const std::vector<Value>& args) {
-        m_env.push_back({});
-        for (size_t i = 0; i < fn->params.size() && i < args.size(); ++i) {
-            m_env.back()[fn->params[i]->name] = args[i];
+    // Arguments have already been evaluated onto the binding stack from argBase;
+    // naming them turns them into the callee's parameters without copying.
+    Value RuntimeEvaluator::call(FunctionDeclaration* fn, size_t argBase) {
+        size_t argCount = m_bindings.size() - argBase;
+        for (size_t i = 0; i < fn->params.size() && i < argCount; ++i) {
+            m_bindings[argBase + i].name = fn->params[i]->name;
         }
+        ExecutionProfiler::FunctionScope profiled(m_profiler, *fn);
+        TraceRecorder::Span span(m_trace, TraceCategory::Call, fn->name);
+        m_frames.push_back(argBase);
+        m_scopes.push_back(argBase);
         m_hasReturn = false;
+        m_returnValue = {};
         if (fn->body)
             for (auto& stmt : fn->body->statements) {
                 exec(stmt.get());
                 if (m_hasReturn)
                     break;
             }
-        Value ret = m_returnValue;
-        m_env.pop_back();
-        return ret;
+        // a return only unwinds the callee, never the caller's statements
+        m_hasReturn = false;
+        endScope();
+        m_frames.pop_back();
+        return m_returnValue;
+    }
+
+    Value RuntimeEvaluator::callBuiltin(Symbol name, CallExpression* callExpr) {
+        std::array<Value, 2> args;
+        for (size_t i = 0; i < callExpr->arguments.size() && i < args.size(); ++i)
+            args[i] = eval(callExpr->arguments[i].get());
+        TraceRecorder::Span span(m_trace, TraceCategory::Gate, name);
+        if (name == kH)
+            m_sim.h(args[0].qubit());
+        else if (name == kX)
+            m_sim.x(args[0].qubit());
+        else if (name == kY)
+            m_sim.y(args[0].qubit());
+        else if (name == kZ)
+            m_sim.z(args[0].qubit());
+        else if (name == kRx)
+            m_sim.rx(args[0].qubit(), args[1].asFloat());
+        else if (name == kRy)
+            m_sim.ry(args[0].qubit(), args[1].asFloat());
+        else if (name == kRz)
+            m_sim.rz(args[0].qubit(), args[1].asFloat());
+        else if (name == kCx)
+            m_sim.cx(args[0].qubit(), args[1].qubit());
+        if (m_profiler)
+            m_profiler->gate(m_sim.stateSize());
+        return {};  // void
     }
 
     void RuntimeEvaluator::exec(Statement* s) {
         if (!s)
             return;
+        ExecutionProfiler::LineScope profiled(m_profiler, s);
         if (auto var = dynamic_cast<VariableDeclaration*>(s)) {
             Value v;
             if (auto prim = dynamic_cast<PrimitiveType*>(var->varType.get())) {
                 if (prim->name == "int")
-                    v.type = Value::Type::Int;
+                    v = Value::makeInt(0);
                 else if (prim->name == "bit")
-                    v.type = Value::Type::Bit;
+                    v = Value::makeBit(0);
                 else if (prim->name == "float")
-                    v.type = Value::Type::Float;
-                else if (prim->name == "qubit") {
-                    v.type = Value::Type::Qubit;
-                    v.qubit = allocateTrackedQubit(var->name);
-                }
+                    v = Value::makeFloat(0.0);
+                else if (prim->name == "qubit")
+                    v = Value::makeQubit(allocateTrackedQubit(var->name));
             }
             if (var->initializer)
-                v = eval(var->initializer.get());
-            m_env.back()[var->name] = v;
+                v = eval(var->initializer.get()).convertTo(v.type());
+            declare(var->name, v);
         } else if (auto block = dynamic_cast<BlockStatement*>(s)) {
-            m_env.push_back({});
+            beginScope();
             for (auto& st : block->statements) {
                 exec(st.get());
                 if (m_hasReturn)
                     break;
             }
-            m_env.pop_back();
+            endScope();
         } else if (auto exprs = dynamic_cast<ExpressionStatement*>(s)) {
             eval(exprs->expression.get());
         } else if (auto ret = dynamic_cast<ReturnStatement*>(s)) {
@@ -87,21 +153,17 @@ namespace bloch {
                 m_returnValue = eval(ret->value.get());
             m_hasReturn = true;
         } else if (auto ifs = dynamic_cast<IfStatement*>(s)) {
-            Value cond = eval(ifs->condition.get());
-            if (cond.intValue || cond.bitValue) {
+            if (eval(ifs->condition.get()).truthy()) {
                 exec(ifs->thenBranch.get());
             } else {
                 exec(ifs->elseBranch.get());
             }
         } else if (auto fors = dynamic_cast<ForStatement*>(s)) {
-            m_env.push_back({});
+            beginScope();
             if (fors->initializer)
                 exec(fors->initializer.get());
             while (true) {
-                Value c = {Value::Type::Bit, 0, 0.0, 0};
-                if (fors->condition)
-                    c = eval(fors->condition.get());
-                if (!(c.intValue || c.bitValue))
+                if (fors->condition && !eval(fors->condition.get()).truthy())
                     break;
                 exec(fors->body.get());
                 if (m_hasReturn)
@@ -109,21 +171,26 @@ namespace bloch {
                 if (fors->increment)
                     eval(fors->increment.get());
             }
-            m_env.pop_back();
+            endScope();
         } else if (auto echo = dynamic_cast<EchoStatement*>(s)) {
             Value v = eval(echo->value.get());
-            std::cout << (v.type == Value::Type::Int ? std::to_string(v.intValue)
-                                                     : std::to_string(v.bitValue))
-                      << std::endl;
-        } else if (auto reset = dynamic_cast<ResetStatement*>(s)) {
+            if (v.isFloat())
+                m_out << v.asFloat() << '\n';
+            else
+                m_out << v.asInt() << '\n';
+        } else if (dynamic_cast<ResetStatement*>(s)) {
             // ignore
         } else if (auto meas = dynamic_cast<MeasureStatement*>(s)) {
             Value q = eval(meas->qubit.get());
-            m_sim.measure(q.qubit);
-            markMeasured(q.qubit);
+            {
+                TraceRecorder::Span span(m_trace, TraceCategory::Measure, kMeasureSpan);
+                m_sim.measure(q.qubit());
+            }
+            if (m_profiler)
+                m_profiler->measurement(m_sim.stateSize());
+            markMeasured(q.qubit());
         } else if (auto assignStmt = dynamic_cast<AssignmentStatement*>(s)) {
-            Value val = eval(assignStmt->value.get());
-            assign(assignStmt->name, val);
+            assign(assignStmt->name, eval(assignStmt->value.get()));
         }
     }
 
@@ -131,105 +198,61 @@ namespace bloch {
         if (!e)
             return {};
         if (auto lit = dynamic_cast<LiteralExpression*>(e)) {
-            Value v;
-            v.type = Value::Type::Int;
-            v.intValue = std::stoi(lit->value);
-            if (lit->literalType == "bit") {
-                v.type = Value::Type::Bit;
-                v.bitValue = std::stoi(lit->value);
+            switch (lit->kind) {
+                case LiteralKind::Bit:
+                    return Value::makeBit(lit->intValue);
+                case LiteralKind::Float:
+                    return Value::makeFloat(lit->floatValue);
+                default:
+                    return Value::makeInt(lit->intValue);
             }
-            return v;
         } else if (auto var = dynamic_cast<VariableExpression*>(e)) {
             return lookup(var->name);
         } else if (auto bin = dynamic_cast<BinaryExpression*>(e)) {
             Value l = eval(bin->left.get());
             Value r = eval(bin->right.get());
-            if (bin->op == "+") {
-                return {Value::Type::Int, l.intValue + r.intValue};
-            }
-            if (bin->op == "-") {
-                return {Value::Type::Int, l.intValue - r.intValue};
-            }
-            if (bin->op == "*") {
-                return {Value::Type::Int, l.intValue * r.intValue};
-            }
-            if (bin->op == "/") {
-                if (r.intValue == 0) {
-                    throw std::runtime_error("Division by zero in expression evaluation");
-                }
-                return {Value::Type::Int, l.intValue / r.intValue};
-            }
-            if (bin->op == "%") {
-                if (r.intValue == 0) {
-                    throw std::runtime_error("Modulo by zero in expression evaluation");
-                }
-                return {Value::Type::Int, l.intValue % r.intValue};
-            }
-
-            if (bin->op == ">") {
-                return {Value::Type::Bit, 0, 0.0, l.intValue > r.intValue};
-            }
-            if (bin->op == "<") {
-                return {Value::Type::Bit, 0, 0.0, l.intValue < r.intValue};
-            }
-            if (bin->op == ">=") {
-                return {Value::Type::Bit, 0, 0.0, l.intValue >= r.intValue};
-            }
-            if (bin->op == "<=") {
-                return {Value::Type::Bit, 0, 0.0, l.intValue <= r.intValue};
-            }
-            if (bin->op == "==") {
-                return {Value::Type::Bit, 0, 0.0, l.intValue == r.intValue};
-            }
-            if (bin->op == "!=") {
-                return {Value::Type::Bit, 0, 0.0, l.intValue != r.intValue};
-            }
+            return binary(bin->op, l, r);
         } else if (auto unary = dynamic_cast<UnaryExpression*>(e)) {
             Value r = eval(unary->right.get());
-            if (unary->op == "-") {
-                return {Value::Type::Int, -r.intValue};
+            if (unary->op == UnaryOp::Negate) {
+                if (r.isFloat())
+                    return Value::makeFloat(-r.asFloat());
+                return Value::makeInt(-r.asInt());
             }
             return r;
+        } else if (auto paren = dynamic_cast<ParenthesizedExpression*>(e)) {
+            return eval(paren->expression.get());
         } else if (auto callExpr = dynamic_cast<CallExpression*>(e)) {
             if (auto var = dynamic_cast<VariableExpression*>(callExpr->callee.get())) {
-                auto name = var->name;
-                auto builtin = builtInGates.find(name);
-                std::vector<Value> args;
-                for (auto& a : callExpr->arguments) args.push_back(eval(a.get()));
-                if (builtin != builtInGates.end()) {
-                    if (name == "h")
-                        m_sim.h(args[0].qubit);
-                    else if (name == "x")
-                        m_sim.x(args[0].qubit);
-                    else if (name == "y")
-                        m_sim.y(args[0].qubit);
-                    else if (name == "z")
-                        m_sim.z(args[0].qubit);
-                    else if (name == "rx")
-                        m_sim.rx(args[0].qubit, args[1].floatValue);
-                    else if (name == "ry")
-                        m_sim.ry(args[0].qubit, args[1].floatValue);
-                    else if (name == "rz")
-                        m_sim.rz(args[0].qubit, args[1].floatValue);
-                    else if (name == "cx")
-                        m_sim.cx(args[0].qubit, args[1].qubit);
-                    return {};  // void
-                }
-                auto fit = m_functions.find(name);
-                if (fit != m_functions.end()) {
-                    auto res = call(fit->second, args);
-                    if (fit->second->hasQuantumAnnotation && res.type == Value::Type::Bit) {
-                        m_measurements[e] = res.bitValue;
+                Symbol name = var->name;
+                if (builtInGates.count(name))
+                    return callBuiltin(name, callExpr);
+                if (FunctionDeclaration* callee = function(name)) {
+                    // evaluate arguments straight into the callee's frame
+                    size_t argBase = m_bindings.size();
+                    for (auto& a : callExpr->arguments) {
+                        Value arg = eval(a.get());
+                        m_bindings.push_back({Symbol(), arg});
+                    }
+                    Value res = call(callee, argBase);
+                    if (callee->hasQuantumAnnotation && res.type() == Value::Type::Bit) {
+                        m_measurements[e] = res.asBit();
                     }
                     return res;
                 }
             }
         } else if (auto idx = dynamic_cast<MeasureExpression*>(e)) {
             Value q = eval(idx->qubit.get());
-            int bit = m_sim.measure(q.qubit);
-            markMeasured(q.qubit);
+            int bit;
+            {
+                TraceRecorder::Span span(m_trace, TraceCategory::Measure, kMeasureSpan);
+                bit = m_sim.measure(q.qubit());
+            }
+            if (m_profiler)
+                m_profiler->measurement(m_sim.stateSize());
+            markMeasured(q.qubit());
             m_measurements[e] = bit;
-            return {Value::Type::Bit, 0, 0.0, bit};
+            return Value::makeBit(bit);
         } else if (auto assignExpr = dynamic_cast<AssignmentExpression*>(e)) {
             Value v = eval(assignExpr->value.get());
             assign(assignExpr->name, v);
@@ -238,8 +261,74 @@ namespace bloch {
         return {};
     }
 
-    int RuntimeEvaluator::allocateTrackedQubit(const std::string& name) {
+    Value RuntimeEvaluator::binary(BinaryOp op, Value l, Value r) {
+        if (l.isFloat() || r.isFloat()) {
+            double a = l.asFloat();
+            double b = r.asFloat();
+            switch (op) {
+                case BinaryOp::Add:
+                    return Value::makeFloat(a + b);
+                case BinaryOp::Subtract:
+                    return Value::makeFloat(a - b);
+                case BinaryOp::Multiply:
+                    return Value::makeFloat(a * b);
+                case BinaryOp::Divide:
+                    return Value::makeFloat(a / b);
+                case BinaryOp::Greater:
+                    return Value::makeBit(a > b);
+                case BinaryOp::Less:
+                    return Value::makeBit(a < b);
+                case BinaryOp::GreaterEqual:
+                    return Value::makeBit(a >= b);
+                case BinaryOp::LessEqual:
+                    return Value::makeBit(a <= b);
+                case BinaryOp::Equal:
+                    return Value::makeBit(a == b);
+                case BinaryOp::NotEqual:
+                    return Value::makeBit(a != b);
+                case BinaryOp::Modulo:
+                    break;  // integer only, handled below
+            }
+        }
+        int a = l.asInt();
+        int b = r.asInt();
+        switch (op) {
+            case BinaryOp::Add:
+                return Value::makeInt(a + b);
+            case BinaryOp::Subtract:
+                return Value::makeInt(a - b);
+            case BinaryOp::Multiply:
+                return Value::makeInt(a * b);
+            case BinaryOp::Divide:
+                if (b == 0) {
+                    throw std::runtime_error("Division by zero in expression evaluation");
+                }
+                return Value::makeInt(a / b);
+            case BinaryOp::Modulo:
+                if (b == 0) {
+                    throw std::runtime_error("Modulo by zero in expression evaluation");
+                }
+                return Value::makeInt(a % b);
+            case BinaryOp::Greater:
+                return Value::makeBit(a > b);
+            case BinaryOp::Less:
+                return Value::makeBit(a < b);
+            case BinaryOp::GreaterEqual:
+                return Value::makeBit(a >= b);
+            case BinaryOp::LessEqual:
+                return Value::makeBit(a <= b);
+            case BinaryOp::Equal:
+                return Value::makeBit(a == b);
+            case BinaryOp::NotEqual:
+                return Value::makeBit(a != b);
+        }
+        return {};
+    }
+
+    int RuntimeEvaluator::allocateTrackedQubit(Symbol name) {
         int idx = m_sim.allocateQubit();
+        if (m_profiler)
+            m_profiler->allocation(m_sim.stateSize());
         m_qubits.push_back({name, false});
         return idx;
     }
@@ -1,51 +1,126 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "../ast/ast.hpp"
+#include "../profiling/execution_profiler.hpp"
+#include "../profiling/trace_recorder.hpp"
 #include "qasm_simulator.hpp"
 
 namespace bloch {
 
-    struct Value {
-        enum class Type { Int, Float, Bit, Qubit, Void };
-        Type type = Type::Void;
-        int intValue = 0;
-        double floatValue = 0.0;
-        int bitValue = 0;
-        int qubit = -1;
+    // 16-byte tagged union holding a runtime value. The payload is read through
+    // typed accessors which convert between the numeric kinds where needed.
+    class Value {
+       public:
+        enum class Type : std::uint8_t { Int, Float, Bit, Qubit, Void };
+
+        constexpr Value() noexcept : m_type(Type::Void), m_int(0) {}
+
+        static constexpr Value makeInt(int v) noexcept { return Value(Type::Int, v); }
+        static constexpr Value makeBit(int v) noexcept { return Value(Type::Bit, v != 0); }
+        static constexpr Value makeQubit(int index) noexcept { return Value(Type::Qubit, index); }
+        static constexpr Value makeFloat(double v) noexcept { return Value(v); }
+
+        constexpr Type type() const noexcept { return m_type; }
+        constexpr bool isFloat() const noexcept { return m_type == Type::Float; }
+
+        constexpr int asInt() const noexcept {
+            return m_type == Type::Float ? static_cast<int>(m_float) : m_int;
+        }
+        constexpr double asFloat() const noexcept {
+            return m_type == Type::Float ? m_float : static_cast<double>(m_int);
+        }
+        constexpr int asBit() const noexcept { return truthy() ? 1 : 0; }
+        constexpr int qubit() const noexcept { return m_type == Type::Qubit ? m_int : -1; }
+        constexpr bool truthy() const noexcept {
+            return m_type == Type::Float ? m_float != 0.0 : m_int != 0;
+        }
+
+        // Converts a value to the declared type of the variable it is stored in
+        constexpr Value convertTo(Type target) const noexcept {
+            switch (target) {
+                case Type::Int:
+                    return makeInt(asInt());
+                case Type::Float:
+                    return makeFloat(asFloat());
+                case Type::Bit:
+                    return makeBit(asBit());
+                default:
+                    return *this;
+            }
+        }
+
+       private:
+        constexpr Value(Type type, int v) noexcept : m_type(type), m_int(v) {}
+        constexpr explicit Value(double v) noexcept : m_type(Type::Float), m_float(v) {}
+
+        Type m_type;
+        union {
+            int m_int;
+            double m_float;
+        };
     };
 
+    static_assert(sizeof(Value) == 16, "Value should stay a compact 16-byte tagged union");
+
     class RuntimeEvaluator {
        public:
+        // `echo` output is written to `out`
+        explicit RuntimeEvaluator(std::ostream& out = std::cout);
         void execute(Program& program);
         const std::unordered_map<const Expression*, int>& measurements() const {
             return m_measurements;
         }
         std::string getQasm() const { return m_sim.getQasm(); }
+        // Reports calls, statements and quantum work to `profiler` when non-null
+        void setProfiler(ExecutionProfiler* profiler) { m_profiler = profiler; }
+        // Records calls, gates and measurements as spans in `trace` when non-null
+        void setTrace(TraceRecorder* trace) { m_trace = trace; }
 
        private:
+        std::ostream& m_out;
         QasmSimulator m_sim;
-        std::unordered_map<std::string, FunctionDeclaration*> m_functions;
-        std::vector<std::unordered_map<std::string, Value>> m_env;
+        ExecutionProfiler* m_profiler = nullptr;
+        TraceRecorder* m_trace = nullptr;
+        // Indexed by the id of the function's name
+        std::vector<FunctionDeclaration*> m_functions;
+        // Variables live on a flat binding stack. Scopes and call frames are indices
+        // into it, so entering a block or calling a function never allocates once
+        // the preallocated capacity is warm. A binding with the empty name is an
+        // argument that is still being evaluated for a pending call.
+        struct Binding {
+            Symbol name;
+            Value value;
+        };
+        std::vector<Binding> m_bindings;
+        std::vector<size_t> m_scopes;
+        std::vector<size_t> m_frames;
         Value m_returnValue;
         bool m_hasReturn = false;
         std::unordered_map<const Expression*, int> m_measurements;
         struct QubitInfo {
-            std::string name;
+            Symbol name;
             bool measured;
         };
         std::vector<QubitInfo> m_qubits;
 
         Value eval(Expression* expr);
+        static Value binary(BinaryOp op, Value l, Value r);
         void exec(Statement* stmt);
-        Value call(FunctionDeclaration* fn, const std::vector<Value>& args);
-        Value lookup(const std::string& name);
-        void assign(const std::string& name, const Value& v);
-        int allocateTrackedQubit(const std::string& name);
+        Value call(FunctionDeclaration* fn, size_t argBase);
+        Value callBuiltin(Symbol name, CallExpression* callExpr);
+        void beginScope();
+        void endScope();
+        FunctionDeclaration* function(Symbol name) const;
+        void declare(Symbol name, Value v);
+        Value lookup(Symbol name) const;
+        void assign(Symbol name, Value v);
+        int allocateTrackedQubit(Symbol name);
         void markMeasured(int index);
         void warnUnmeasured() const;
     };
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "random.hpp"
+
+namespace bloch {
+
+    // State vector whose qubit count and gate targets are compile-time constants.
+    // Generated programs that allocate every qubit up front use it instead of
+    // QasmSimulator: strides become constants, so the compiler can unroll and
+    // vectorise each gate, and out-of-range qubits fail to compile.
+    template <int N>
+    class StaticStateVector {
+       public:
+        static_assert(N >= 0 && N < 40, "unsupported qubit count");
+        using Amplitude = std::complex<double>;
+        static constexpr int kQubits = N;
+        static constexpr size_t kSize = size_t{1} << N;
+
+        StaticStateVector() : m_state(kSize) { m_state[0] = 1.0; }
+
+        // Returns every qubit to |0>
+        void reset() {
+            std::fill(m_state.begin(), m_state.end(), Amplitude{});
+            m_state[0] = 1.0;
+        }
+
+        const Amplitude& amplitude(size_t index) const { return m_state[index]; }
+
+        template <int Q>
+        void h() {
+            static constexpr double s = 0.70710678118654752440;
+            forPairs<Q>([](size_t, Amplitude& a0, Amplitude& a1) {
+                Amplitude t = a0;
+                a0 = (t + a1) * s;
+                a1 = (t - a1) * s;
+            });
+        }
+
+        template <int Q>
+        void x() {
+            forPairs<Q>([](size_t, Amplitude& a0, Amplitude& a1) { std::swap(a0, a1); });
+        }
+
+        template <int Q>
+        void y() {
+            forPairs<Q>([](size_t, Amplitude& a0, Amplitude& a1) {
+                Amplitude t = a0;
+                a0 = Amplitude(a1.imag(), -a1.real());  // -i * a1
+                a1 = Amplitude(-t.imag(), t.real());    // i * a0
+            });
+        }
+
+        template <int Q>
+        void z() {
+            forPairs<Q>([](size_t, Amplitude&, Amplitude& a1) { a1 = -a1; });
+        }
+
+        template <int Q>
+        void rx(double theta) {
+            double c = std::cos(theta / 2);
+            double s = std::sin(theta / 2);
+            forPairs<Q>([c, s](size_t, Amplitude& a0, Amplitude& a1) {
+                Amplitude t = a0;
+                a0 = c * t + Amplitude(0, -s) * a1;
+                a1 = Amplitude(0, -s) * t + c * a1;
+            });
+        }
+
+        template <int Q>
+        void ry(double theta) {
+            double c = std::cos(theta / 2);
+            double s = std::sin(theta / 2);
+            forPairs<Q>([c, s](size_t, Amplitude& a0, Amplitude& a1) {
+                Amplitude t = a0;
+                a0 = c * t - s * a1;
+                a1 = s * t + c * a1;
+            });
+        }
+
+        template <int Q>
+        void rz(double theta) {
+            Amplitude e0 = std::exp(Amplitude(0, -theta / 2));
+            Amplitude e1 = std::exp(Amplitude(0, theta / 2));
+            forPairs<Q>([e0, e1](size_t, Amplitude& a0, Amplitude& a1) {
+                a0 *= e0;
+                a1 *= e1;
+            });
+        }
+
+        template <int C, int T>
+        void cx() {
+            static_assert(C != T, "control and target must differ");
+            constexpr size_t cbit = size_t{1} << C;
+            forPairs<T>([](size_t i, Amplitude& a0, Amplitude& a1) {
+                if (i & cbit)
+                    std::swap(a0, a1);
+            });
+        }
+
+        template <int Q>
+        int measure() {
+            double p1 = 0;
+            forPairs<Q>([&p1](size_t, Amplitude&, Amplitude& a1) { p1 += std::norm(a1); });
+            int res = sampleUniform() < p1 ? 1 : 0;
+            double scale = 1.0 / std::sqrt(res ? p1 : 1 - p1);
+            forPairs<Q>([res, scale](size_t, Amplitude& a0, Amplitude& a1) {
+                Amplitude& kept = res ? a1 : a0;
+                kept *= scale;
+                (res ? a0 : a1) = 0;
+            });
+            return res;
+        }
+
+       private:
+        std::vector<Amplitude> m_state;
+
+        // Calls f(index0, a0, a1) for every pair of amplitudes differing only in bit Q
+        template <int Q, typename F>
+        void forPairs(F f) {
+            static_assert(Q >= 0 && Q < N, "qubit index out of range");
+            constexpr size_t step = size_t{1} << Q;
+            Amplitude* state = m_state.data();
+            for (size_t i = 0; i < kSize; i += 2 * step)
+                for (size_t j = i; j < i + step; ++j) f(j, state[j], state[j + step]);
+        }
+    };
+
+}
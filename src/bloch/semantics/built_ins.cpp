@@ -2,15 +2,15 @@
 
 namespace bloch {
 
-    const std::unordered_map<std::string, BuiltInGate> builtInGates = {
-        {"h", BuiltInGate{"h", {ValueType::Qubit}, ValueType::Void}},
-        {"x", BuiltInGate{"x", {ValueType::Qubit}, ValueType::Void}},
-        {"y", BuiltInGate{"y", {ValueType::Qubit}, ValueType::Void}},
-        {"z", BuiltInGate{"z", {ValueType::Qubit}, ValueType::Void}},
-        {"rx", BuiltInGate{"rx", {ValueType::Qubit, ValueType::Float}, ValueType::Void}},
-        {"ry", BuiltInGate{"ry", {ValueType::Qubit, ValueType::Float}, ValueType::Void}},
-        {"rz", BuiltInGate{"rz", {ValueType::Qubit, ValueType::Float}, ValueType::Void}},
-        {"cx", BuiltInGate{"cx", {ValueType::Qubit, ValueType::Qubit}, ValueType::Void}},
+    const std::unordered_map<Symbol, BuiltInGate> builtInGates = {
+        {Symbol("h"), BuiltInGate{"h", {ValueType::Qubit}, ValueType::Void}},
+        {Symbol("x"), BuiltInGate{"x", {ValueType::Qubit}, ValueType::Void}},
+        {Symbol("y"), BuiltInGate{"y", {ValueType::Qubit}, ValueType::Void}},
+        {Symbol("z"), BuiltInGate{"z", {ValueType::Qubit}, ValueType::Void}},
+        {Symbol("rx"), BuiltInGate{"rx", {ValueType::Qubit, ValueType::Float}, ValueType::Void}},
+        {Symbol("ry"), BuiltInGate{"ry", {ValueType::Qubit, ValueType::Float}, ValueType::Void}},
+        {Symbol("rz"), BuiltInGate{"rz", {ValueType::Qubit, ValueType::Float}, ValueType::Void}},
+        {Symbol("cx"), BuiltInGate{"cx", {ValueType::Qubit, ValueType::Qubit}, ValueType::Void}},
     };
 
 }
\ No newline at end of file
@@ -12,5 +12,6 @@ namespace bloch {
         ValueType returnType;
     };
 
-    extern const std::unordered_map<std::string, BuiltInGate> builtInGates;
+    // Keyed by interned name
+    extern const std::unordered_map<Symbol, BuiltInGate> builtInGates;
 }
\ No newline at end of file
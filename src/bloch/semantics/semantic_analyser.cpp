@@ -21,7 +21,7 @@ namespace bloch {
             type = typeFromString(prim->name);
         else if (dynamic_cast<VoidType*>(node.varType.get()))
             type = ValueType::Void;
-        else if (auto obj = dynamic_cast<ObjectType*>(node.varType.get()))
+        else if (dynamic_cast<ObjectType*>(node.varType.get()))
             type = ValueType::Custom;
         declare(node.name, node.isFinal, type);
         if (node.initializer) {
@@ -169,7 +169,7 @@ namespace bloch {
                                 "' expects type '" + typeToString(expectedType) + "'");
                     }
                 } else if (auto argLit = dynamic_cast<LiteralExpression*>(arg.get())) {
-                    ValueType actual = typeFromString(argLit->literalType);
+                    ValueType actual = typeFromLiteral(argLit->kind);
                     if (actual != ValueType::Unknown && actual != expectedType) {
                         throw BlochRuntimeError(
                             "Bloch Semantic Error", argLit->line, argLit->column,
@@ -276,7 +276,7 @@ namespace bloch {
                 info.paramTypes.push_back(typeFromString(prim->name));
             else if (dynamic_cast<VoidType*>(param->type.get()))
                 info.paramTypes.push_back(ValueType::Void);
-            else if (auto obj = dynamic_cast<ObjectType*>(param->type.get()))
+            else if (dynamic_cast<ObjectType*>(param->type.get()))
                 info.paramTypes.push_back(ValueType::Custom);
             else
                 info.paramTypes.push_back(ValueType::Unknown);
@@ -294,7 +294,7 @@ namespace bloch {
                 type = typeFromString(prim->name);
             else if (dynamic_cast<VoidType*>(param->type.get()))
                 type = ValueType::Void;
-            else if (auto obj = dynamic_cast<ObjectType*>(param->type.get()))
+            else if (dynamic_cast<ObjectType*>(param->type.get()))
                 type = ValueType::Custom;
             declare(param->name, false, type);
             param->accept(*this);
@@ -338,25 +338,25 @@ namespace bloch {
 
     void SemanticAnalyser::endScope() { m_symbols.endScope(); }
 
-    void SemanticAnalyser::declare(const std::string& name, bool isFinalVar, ValueType type) {
+    void SemanticAnalyser::declare(Symbol name, bool isFinalVar, ValueType type) {
         m_symbols.declare(name, isFinalVar, type);
     }
 
-    bool SemanticAnalyser::isDeclared(const std::string& name) const {
+    bool SemanticAnalyser::isDeclared(Symbol name) const {
         return m_symbols.isDeclared(name);
     }
 
-    void SemanticAnalyser::declareFunction(const std::string& name) { m_functions.insert(name); }
+    void SemanticAnalyser::declareFunction(Symbol name) { m_functions.insert(name); }
 
-    bool SemanticAnalyser::isFunctionDeclared(const std::string& name) const {
+    bool SemanticAnalyser::isFunctionDeclared(Symbol name) const {
         return m_functions.count(name) > 0 || builtInGates.count(name) > 0;
     }
 
-    bool SemanticAnalyser::isFinal(const std::string& name) const {
+    bool SemanticAnalyser::isFinal(Symbol name) const {
         return m_symbols.isFinal(name);
     }
 
-    size_t SemanticAnalyser::getFunctionParamCount(const std::string& name) const {
+    size_t SemanticAnalyser::getFunctionParamCount(Symbol name) const {
         auto it = m_functionInfo.find(name);
         if (it != m_functionInfo.end())
             return it->second.paramTypes.size();
@@ -366,7 +366,7 @@ namespace bloch {
         return 0;
     }
 
-    std::vector<ValueType> SemanticAnalyser::getFunctionParamTypes(const std::string& name) const {
+    std::vector<ValueType> SemanticAnalyser::getFunctionParamTypes(Symbol name) const {
         auto it = m_functionInfo.find(name);
         if (it != m_functionInfo.end())
             return it->second.paramTypes;
@@ -376,11 +376,11 @@ namespace bloch {
         return {};
     }
 
-    ValueType SemanticAnalyser::getVariableType(const std::string& name) const {
+    ValueType SemanticAnalyser::getVariableType(Symbol name) const {
         return m_symbols.getType(name);
     }
 
-    bool SemanticAnalyser::returnsVoid(const std::string& name) const {
+    bool SemanticAnalyser::returnsVoid(Symbol name) const {
         auto it = m_functionInfo.find(name);
         if (it != m_functionInfo.end())
             return it->second.returnType == ValueType::Void;
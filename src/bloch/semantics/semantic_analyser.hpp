@@ -54,25 +54,25 @@ namespace bloch {
        private:
         SymbolTable m_symbols;
         ValueType m_currentReturnType = ValueType::Unknown;
-        std::unordered_set<std::string> m_functions;
+        std::unordered_set<Symbol> m_functions;
 
         struct FunctionInfo {
             ValueType returnType = ValueType::Unknown;
             std::vector<ValueType> paramTypes;
         };
-        std::unordered_map<std::string, FunctionInfo> m_functionInfo;
+        std::unordered_map<Symbol, FunctionInfo> m_functionInfo;
 
         void beginScope();
         void endScope();
-        void declare(const std::string& name, bool isFinal, ValueType type);
-        bool isDeclared(const std::string& name) const;
-        void declareFunction(const std::string& name);
-        bool isFunctionDeclared(const std::string& name) const;
-        bool isFinal(const std::string& name) const;
-        size_t getFunctionParamCount(const std::string& name) const;
-        std::vector<ValueType> getFunctionParamTypes(const std::string& name) const;
-        ValueType getVariableType(const std::string& name) const;
-        bool returnsVoid(const std::string& name) const;
+        void declare(Symbol name, bool isFinal, ValueType type);
+        bool isDeclared(Symbol name) const;
+        void declareFunction(Symbol name);
+        bool isFunctionDeclared(Symbol name) const;
+        bool isFinal(Symbol name) const;
+        size_t getFunctionParamCount(Symbol name) const;
+        std::vector<ValueType> getFunctionParamTypes(Symbol name) const;
+        ValueType getVariableType(Symbol name) const;
+        bool returnsVoid(Symbol name) const;
     };
 
 }
\ No newline at end of file
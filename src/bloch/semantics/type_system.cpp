@@ -1,4 +1,5 @@
 #include "type_system.hpp"
+#include <algorithm>
 
 namespace bloch {
 
@@ -43,41 +44,67 @@ namespace bloch {
         }
     }
 
-    void SymbolTable::beginScope() { m_scopes.emplace_back(); }
+    ValueType typeFromLiteral(LiteralKind kind) {
+        switch (kind) {
+            case LiteralKind::Int:
+                return ValueType::Int;
+            case LiteralKind::Float:
+                return ValueType::Float;
+            case LiteralKind::Bit:
+                return ValueType::Bit;
+            case LiteralKind::Char:
+                return ValueType::Char;
+            case LiteralKind::String:
+                return ValueType::String;
+        }
+        return ValueType::Unknown;
+    }
 
-    void SymbolTable::endScope() { m_scopes.pop_back(); }
+    void SymbolTable::beginScope() {
+        m_scopes.push_back(static_cast<uint32_t>(m_bindings.size()));
+    }
+
+    void SymbolTable::endScope() {
+        for (size_t i = m_bindings.size(); i > m_scopes.back(); --i) {
+            const Binding& binding = m_bindings[i - 1];
+            m_latest[binding.name.id()] = binding.shadowed;
+        }
+        m_bindings.resize(m_scopes.back());
+        m_scopes.pop_back();
+    }
 
-    void SymbolTable::declare(const std::string& name, bool isFinal, ValueType type,
+    void SymbolTable::declare(Symbol name, bool isFinal, ValueType type,
                               const std::string& customName) {
         if (m_scopes.empty())
             return;
-        m_scopes.back()[name] = SymbolInfo{isFinal, type, customName};
+        if (name.id() >= m_latest.size())
+            m_latest.resize(std::max<size_t>(Symbol::count(), name.id() + 1), kUnbound);
+        uint32_t& latest = m_latest[name.id()];
+        // redeclaring within the same scope replaces the binding
+        if (latest != kUnbound && latest >= m_scopes.back()) {
+            m_bindings[latest].info = SymbolInfo{isFinal, type, customName};
+            return;
+        }
+        m_bindings.push_back(Binding{name, latest, SymbolInfo{isFinal, type, customName}});
+        latest = static_cast<uint32_t>(m_bindings.size() - 1);
     }
 
-    bool SymbolTable::isDeclared(const std::string& name) const {
-        for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it) {
-            if (it->count(name))
-                return true;
-        }
-        return false;
+    const SymbolInfo* SymbolTable::find(Symbol name) const {
+        if (name.id() >= m_latest.size() || m_latest[name.id()] == kUnbound)
+            return nullptr;
+        return &m_bindings[m_latest[name.id()]].info;
     }
 
-    bool SymbolTable::isFinal(const std::string& name) const {
-        for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it) {
-            auto found = it->find(name);
-            if (found != it->end())
-                return found->second.isFinal;
-        }
-        return false;
+    bool SymbolTable::isDeclared(Symbol name) const { return find(name) != nullptr; }
+
+    bool SymbolTable::isFinal(Symbol name) const {
+        const SymbolInfo* info = find(name);
+        return info && info->isFinal;
     }
 
-    ValueType SymbolTable::getType(const std::string& name) const {
-        for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it) {
-            auto found = it->find(name);
-            if (found != it->end())
-                return found->second.type;
-        }
-        return ValueType::Unknown;
+    ValueType SymbolTable::getType(Symbol name) const {
+        const SymbolInfo* info = find(name);
+        return info ? info->type : ValueType::Unknown;
     }
 
 }  // namespace bloch
\ No newline at end of file
@@ -1,15 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "../ast/ast.hpp"
+
 namespace bloch {
 
     enum class ValueType { Int, Float, String, Char, Qubit, Bit, Void, Custom, Unknown };
 
     ValueType typeFromString(const std::string& name);
     std::string typeToString(ValueType type);
+    ValueType typeFromLiteral(LiteralKind kind);
 
     struct SymbolInfo {
         bool isFinal = false;
@@ -17,17 +20,34 @@ namespace bloch {
         std::string customName;
     };
 
+    // Declarations live on one flat stack with the start of each scope
+    // recorded as an index into it. Each symbol id maps to its innermost
+    // binding, and every binding remembers the one it shadows, so lookups are
+    // a single index and leaving a scope only unwinds the bindings it added.
     class SymbolTable {
        public:
         void beginScope();
         void endScope();
-        void declare(const std::string& name, bool isFinal, ValueType type,
+        void declare(Symbol name, bool isFinal, ValueType type,
                      const std::string& customName = "");
-        bool isDeclared(const std::string& name) const;
-        bool isFinal(const std::string& name) const;
-        ValueType getType(const std::string& name) const;
+        bool isDeclared(Symbol name) const;
+        bool isFinal(Symbol name) const;
+        ValueType getType(Symbol name) const;
 
        private:
-        std::vector<std::unordered_map<std::string, SymbolInfo>> m_scopes;
+        static constexpr uint32_t kUnbound = UINT32_MAX;
+
+        struct Binding {
+            Symbol name;
+            uint32_t shadowed;
+            SymbolInfo info;
+        };
+
+        const SymbolInfo* find(Symbol name) const;
+
+        std::vector<Binding> m_bindings;
+        std::vector<uint32_t> m_scopes;
+        // Indexed by symbol id
+        std::vector<uint32_t> m_latest;
     };
 }
\ No newline at end of file
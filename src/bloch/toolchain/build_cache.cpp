@@ -0,0 +1,130 @@
+#include "build_cache.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace bloch {
+
+    namespace {
+        // 128-bit FNV-1a, kept as two 64-bit halves so it builds under -pedantic
+        struct Hash128 {
+            uint64_t high = 0x6c62272e07bb0142ull;
+            uint64_t low = 0x62b821756295c58dull;
+        };
+
+        // Multiplies by the FNV prime 2^88 + 0x13b, modulo 2^128
+        void multiplyByPrime(Hash128& hash) {
+            constexpr uint64_t kLowFactor = 0x13b;
+            uint64_t lowLow = (hash.low & 0xffffffffull) * kLowFactor;
+            uint64_t lowHigh = (hash.low >> 32) * kLowFactor;
+            uint64_t carry = (lowHigh + (lowLow >> 32)) >> 32;
+            uint64_t high = hash.high * kLowFactor + carry + (hash.low << 24);
+            hash.low *= kLowFactor;
+            hash.high = high;
+        }
+
+        void mix(Hash128& hash, const std::string& data) {
+            for (unsigned char c : data) {
+                hash.low ^= c;
+                multiplyByPrime(hash);
+            }
+        }
+
+        std::string toHex(const Hash128& hash) {
+            static const char* digits = "0123456789abcdef";
+            std::string out(32, '0');
+            uint64_t halves[] = {hash.high, hash.low};
+            for (int i = 0; i < 32; ++i)
+                out[i] = digits[(halves[i / 16] >> (60 - 4 * (i % 16))) & 0xf];
+            return out;
+        }
+    }
+
+    BuildCache::BuildCache(fs::path directory, std::uintmax_t maxBytes)
+        : m_directory(std::move(directory)), m_maxBytes(maxBytes) {}
+
+    fs::path BuildCache::defaultDirectory() {
+        if (const char* dir = std::getenv("BLOCH_CACHE_DIR"); dir && *dir)
+            return dir;
+        if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+            return fs::path(xdg) / "bloch";
+        if (const char* home = std::getenv("HOME"); home && *home)
+            return fs::path(home) / ".cache" / "bloch";
+        return fs::temp_directory_path() / "bloch-cache";
+    }
+
+    std::string BuildCache::key(const std::string& source, const std::string& command) {
+        Hash128 hash;
+        mix(hash, command);
+        // keeps "ab" + "c" distinct from "a" + "bc"
+        mix(hash, std::string(1, '\0'));
+        mix(hash, source);
+        return toHex(hash);
+    }
+
+    fs::path BuildCache::entryPath(const std::string& key) const { return m_directory / key; }
+
+    std::optional<fs::path> BuildCache::lookup(const std::string& key) const {
+        std::error_code ec;
+        fs::path path = entryPath(key);
+        if (!fs::is_regular_file(path, ec))
+            return std::nullopt;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+        return path;
+    }
+
+    std::optional<fs::path> BuildCache::store(const std::string& key, const fs::path& executable) {
+        std::error_code ec;
+        fs::create_directories(m_directory, ec);
+        if (ec)
+            return std::nullopt;
+        // copy under a private name first so concurrent runs never see a partial file
+        fs::path path = entryPath(key);
+        fs::path temp = m_directory / (key + ".tmp" + std::to_string(::getpid()));
+        fs::copy_file(executable, temp, fs::copy_options::overwrite_existing, ec);
+        if (!ec)
+            fs::rename(temp, path, ec);
+        if (ec) {
+            fs::remove(temp, ec);
+            return std::nullopt;
+        }
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+        evict();
+        return path;
+    }
+
+    void BuildCache::evict() const {
+        struct Entry {
+            fs::path path;
+            fs::file_time_type used;
+            std::uintmax_t size;
+        };
+        std::vector<Entry> entries;
+        std::uintmax_t total = 0;
+        std::error_code ec;
+        for (fs::directory_iterator it(m_directory, ec), end; !ec && it != end;
+             it.increment(ec)) {
+            std::error_code entryEc;
+            if (!it->is_regular_file(entryEc))
+                continue;
+            Entry entry{it->path(), it->last_write_time(entryEc), it->file_size(entryEc)};
+            if (entryEc)
+                continue;
+            total += entry.size;
+            entries.push_back(std::move(entry));
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry& a, const Entry& b) { return a.used < b.used; });
+        // the most recently used entry is always kept
+        for (size_t i = 0; total > m_maxBytes && i + 1 < entries.size(); ++i) {
+            if (fs::remove(entries[i].path, ec))
+                total -= entries[i].size;
+        }
+    }
+
+}
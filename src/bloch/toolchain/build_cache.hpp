@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace bloch {
+
+    // Content-addressed store of compiled executables. Entries are keyed on a
+    // hash of the generated source and the compiler command, and the least
+    // recently used entries are evicted once the cache grows past its size limit.
+    class BuildCache {
+       public:
+        static constexpr std::uintmax_t kDefaultMaxBytes = 256ull * 1024 * 1024;
+
+        explicit BuildCache(std::filesystem::path directory,
+                            std::uintmax_t maxBytes = kDefaultMaxBytes);
+
+        // $BLOCH_CACHE_DIR, then $XDG_CACHE_HOME/bloch, then ~/.cache/bloch
+        static std::filesystem::path defaultDirectory();
+        static std::string key(const std::string& source, const std::string& command);
+
+        const std::filesystem::path& directory() const { return m_directory; }
+        std::filesystem::path entryPath(const std::string& key) const;
+
+        // Returns the cached executable and marks it as recently used
+        std::optional<std::filesystem::path> lookup(const std::string& key) const;
+        // Copies an executable into the cache, returning its cached path
+        std::optional<std::filesystem::path> store(const std::string& key,
+                                                   const std::filesystem::path& executable);
+        void evict() const;
+
+       private:
+        std::filesystem::path m_directory;
+        std::uintmax_t m_maxBytes;
+    };
+
+}
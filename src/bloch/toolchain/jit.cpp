@@ -0,0 +1,75 @@
+#include "jit.hpp"
+#include <dlfcn.h>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace bloch {
+
+    namespace {
+        NativeCompileOptions sharedObjectOptions(NativeCompileOptions options) {
+            options.linkRuntime = true;
+            options.sharedLibrary = true;
+            options.profileGuided = false;
+            return options;
+        }
+    }
+
+    JitProgram::JitProgram(const fs::path& library) {
+        // RTLD_LOCAL keeps the symbols of separately loaded programs apart
+        m_handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!m_handle)
+            throw std::runtime_error(std::string("Failed to load ") + library.string() + ": " +
+                                     dlerror());
+        m_entry = reinterpret_cast<EntryPoint>(dlsym(m_handle, "bloch_run"));
+        if (!m_entry) {
+            dlclose(m_handle);
+            throw std::runtime_error("No bloch_run entry point in " + library.string());
+        }
+    }
+
+    JitProgram::~JitProgram() {
+        if (m_handle)
+            dlclose(m_handle);
+    }
+
+    Jit::Jit(NativeCompileOptions options, BuildCache* cache)
+        : m_compiler(sharedObjectOptions(options)), m_cache(cache) {}
+
+    std::shared_ptr<JitProgram> Jit::load(const std::string& cpp) {
+        std::string key = BuildCache::key(cpp, m_compiler.fingerprint());
+        auto loaded = m_programs.find(key);
+        if (loaded != m_programs.end())
+            return loaded->second;
+
+        std::optional<fs::path> library = m_cache ? m_cache->lookup(key) : std::nullopt;
+        std::error_code ec;
+        fs::path temp = fs::temp_directory_path() /
+                        ("bloch-jit-" + key + "-" + std::to_string(::getpid()));
+        if (!library) {
+            fs::path source = temp.string() + ".cpp";
+            fs::path object = temp.string() + ".so";
+            std::ofstream(source) << cpp;
+            bool built = m_compiler.compile(source.string(), object.string());
+            fs::remove(source, ec);
+            if (!built)
+                throw std::runtime_error("Failed to compile generated C++");
+            library = m_cache ? m_cache->store(key, object) : std::nullopt;
+            if (library)
+                fs::remove(object, ec);
+            else
+                library = object;
+        }
+        auto program = std::make_shared<JitProgram>(*library);
+        // without a cache the shared object is only needed until it is mapped
+        if (*library == fs::path(temp.string() + ".so"))
+            fs::remove(*library, ec);
+        m_programs.emplace(key, program);
+        return program;
+    }
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "build_cache.hpp"
+#include "native_compiler.hpp"
+
+namespace bloch {
+
+    // A generated program loaded into this process as a shared object. The
+    // library stays loaded for as long as the object is alive.
+    class JitProgram {
+       public:
+        using EntryPoint = int (*)(int shots);
+
+        // Throws std::runtime_error when the library or its entry point is missing
+        explicit JitProgram(const std::filesystem::path& library);
+        ~JitProgram();
+        JitProgram(const JitProgram&) = delete;
+        JitProgram& operator=(const JitProgram&) = delete;
+
+        int run(int shots = 1) const { return m_entry(shots); }
+
+       private:
+        void* m_handle = nullptr;
+        EntryPoint m_entry = nullptr;
+    };
+
+    // Compiles programs generated with CppGeneratorOptions::sharedLibrary into
+    // shared objects and loads them. Loaded programs are kept by source hash, so
+    // an embedding host that loads the same program again reuses the handle, and
+    // the shared objects themselves go through the BuildCache when one is given.
+    class Jit {
+       public:
+        // Profile-guided builds need an executable to train, so they are ignored here
+        explicit Jit(NativeCompileOptions options, BuildCache* cache = nullptr);
+
+        // Throws std::runtime_error when compiling or loading fails
+        std::shared_ptr<JitProgram> load(const std::string& cpp);
+        size_t loadedPrograms() const { return m_programs.size(); }
+
+       private:
+        NativeCompiler m_compiler;
+        BuildCache* m_cache;
+        std::unordered_map<std::string, std::shared_ptr<JitProgram>> m_programs;
+    };
+
+}
@@ -0,0 +1,92 @@
+#include "native_compiler.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <system_error>
+
+#ifndef BLOCH_RUNTIME_INCLUDE_DIR
+#define BLOCH_RUNTIME_INCLUDE_DIR ""
+#endif
+#ifndef BLOCH_RUNTIME_LIBRARY
+#define BLOCH_RUNTIME_LIBRARY ""
+#endif
+
+namespace bloch {
+
+    namespace {
+        std::string fromEnv(const char* name, const char* fallback) {
+            const char* value = std::getenv(name);
+            return value && *value ? value : fallback;
+        }
+
+        std::string quote(const std::string& path) { return "\"" + path + "\""; }
+    }
+
+    std::string NativeCompiler::runtimeIncludeDir() {
+        return fromEnv("BLOCH_RUNTIME_INCLUDE", BLOCH_RUNTIME_INCLUDE_DIR);
+    }
+
+    std::string NativeCompiler::runtimeLibrary() {
+        return fromEnv("BLOCH_RUNTIME_LIB", BLOCH_RUNTIME_LIBRARY);
+    }
+
+    std::string NativeCompiler::compilerPath() { return fromEnv("CXX", "g++"); }
+
+    std::string NativeCompiler::command() const {
+        // $CXX may carry its own arguments (e.g. "ccache g++"), so it is not quoted
+        std::string cmd = compilerPath() + " -std=c++17 -O" + std::to_string(m_options.optLevel);
+        if (m_options.nativeArch)
+            cmd += " -march=native";
+        if (m_options.sharedLibrary)
+            cmd += " -shared -fPIC";
+        if (m_options.linkRuntime)
+            cmd += " -I" + quote(runtimeIncludeDir());
+        return cmd;
+    }
+
+    std::string NativeCompiler::fingerprint(const std::string& trainingArgs) const {
+        std::string id = command();
+        if (m_options.profileGuided)
+            id += " pgo " + trainingArgs;
+        if (m_options.linkRuntime) {
+            std::error_code ec;
+            auto stamp = std::filesystem::last_write_time(runtimeLibrary(), ec);
+            id += " " + runtimeLibrary() + "@" + std::to_string(stamp.time_since_epoch().count());
+        }
+        return id;
+    }
+
+    bool NativeCompiler::compile(const std::string& sourcePath, const std::string& outputPath,
+                                 const std::string& trainingArgs) const {
+        if (!m_options.profileGuided)
+            return run(sourcePath, outputPath, "");
+
+        std::string profileDir = outputPath + ".profile";
+        std::error_code ec;
+        std::filesystem::remove_all(profileDir, ec);
+        if (!run(sourcePath, outputPath, "-fprofile-generate=" + quote(profileDir)))
+            return false;
+        // the training run only has to leave its profile behind
+        std::string executable = std::filesystem::absolute(outputPath).string();
+        std::string train = quote(executable) + " " + trainingArgs + " > /dev/null";
+        if (std::system(train.c_str()) != 0)
+            return false;
+        bool built = run(sourcePath, outputPath,
+                         "-fprofile-use=" + quote(profileDir) +
+                             " -fprofile-correction -Wno-missing-profile");
+        std::filesystem::remove_all(profileDir, ec);
+        return built;
+    }
+
+    bool NativeCompiler::run(const std::string& sourcePath, const std::string& outputPath,
+                             const std::string& extraFlags) const {
+        std::string cmd = command();
+        if (!extraFlags.empty())
+            cmd += " " + extraFlags;
+        cmd += " " + quote(sourcePath) + " -o " + quote(outputPath);
+        // the archive has to follow the sources that reference it
+        if (m_options.linkRuntime)
+            cmd += " " + quote(runtimeLibrary());
+        return std::system(cmd.c_str()) == 0;
+    }
+
+}
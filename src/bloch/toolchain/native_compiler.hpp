@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+
+namespace bloch {
+
+    struct NativeCompileOptions {
+        // link against bloch_runtime, needed for CppTarget::NativeSimulator output
+        bool linkRuntime = false;
+        // -O<optLevel>, from 0 to 3
+        int optLevel = 2;
+        // -march=native
+        bool nativeArch = false;
+        // build an instrumented binary, run it once, then rebuild with its profile
+        bool profileGuided = false;
+        // build a shared object for JIT loading instead of an executable
+        bool sharedLibrary = false;
+    };
+
+    // Builds generated C++ into an executable or shared object with the host compiler.
+    class NativeCompiler {
+       public:
+        explicit NativeCompiler(NativeCompileOptions options = {}) : m_options(options) {}
+
+        // $CXX, or g++ when unset
+        static std::string compilerPath();
+        // Compiler and flags, excluding input and output paths
+        std::string command() const;
+        // Identifies everything that affects the output besides the source, for
+        // use as a cache key: the command, the runtime library's timestamp and,
+        // for profile-guided builds, the `trainingArgs` passed to compile()
+        std::string fingerprint(const std::string& trainingArgs = "") const;
+        // Returns false when the compiler reports an error. With profileGuided,
+        // the instrumented binary is run with `trainingArgs` between the two builds.
+        bool compile(const std::string& sourcePath, const std::string& outputPath,
+                     const std::string& trainingArgs = "") const;
+
+        // Locations baked in at build time, overridable with $BLOCH_RUNTIME_INCLUDE
+        // and $BLOCH_RUNTIME_LIB
+        static std::string runtimeIncludeDir();
+        static std::string runtimeLibrary();
+
+       private:
+        NativeCompileOptions m_options;
+
+        bool run(const std::string& sourcePath, const std::string& outputPath,
+                 const std::string& extraFlags) const;
+    };
+
+}
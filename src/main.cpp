@@ -1,79 +1,263 @@
+#include <sys/wait.h>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "bloch/codegen/cpp_generator.hpp"
 #include "bloch/lexer/lexer.hpp"
+#include "bloch/lexer/source_file.hpp"
+#include "bloch/optimiser/inliner.hpp"
+#include "bloch/optimiser/optimiser.hpp"
 #include "bloch/parser/parser.hpp"
+#include "bloch/profiling/execution_profiler.hpp"
+#include "bloch/profiling/phase_timer.hpp"
+#include "bloch/profiling/trace_recorder.hpp"
 #include "bloch/runtime/runtime_evaluator.hpp"
 #include "bloch/semantics/semantic_analyser.hpp"
+#include "bloch/toolchain/build_cache.hpp"
+#include "bloch/toolchain/jit.hpp"
+#include "bloch/toolchain/native_compiler.hpp"
+
+namespace {
+    enum class PhaseReport { None, Text, Json };
+
+    struct CliOptions {
+        bool emitQasm = false;
+        bool emitCpp = false;
+        bool native = false;
+        bool jit = false;
+        bool optStats = false;
+        bool useCache = true;
+        bool specialiseQubits = false;
+        bool profile = false;
+        // codegen target for --emit-cpp; --native and --jit need the simulator target
+        bloch::CppTarget target = bloch::CppTarget::NativeSimulator;
+        PhaseReport phaseReport = PhaseReport::None;
+        std::string tracePath;
+        bloch::NativeCompileOptions compile;
+        int shots = 1;
+        std::string file;
+    };
+
+    int compileAndRun(const CliOptions& opts, std::string_view src, bloch::PhaseTimer& timer,
+                      bloch::TraceRecorder* trace) {
+        // the parser pulls tokens from the lexer, so lexing is timed as part of parsing
+        bloch::Lexer lexer(src);
+        bloch::Parser parser(lexer);
+        auto program = timer.measure("parse", [&] { return parser.parse(); });
+        bloch::SemanticAnalyser analyser;
+        timer.measure("analyse", [&] { analyser.analyse(*program); });
+        bloch::Inliner inliner;
+        // profiles are reported against the functions as written
+        if (!opts.profile)
+            timer.measure("inline", [&] { inliner.inlineCalls(*program); });
+        bloch::Optimiser optimiser;
+        timer.measure("optimise", [&] { optimiser.optimise(*program); });
+        if (opts.optStats) {
+            std::cerr << "inlined calls: " << inliner.inlinedCalls() << "\n";
+            std::cerr << optimiser.stats().summary();
+        }
+
+        // By default the program runs in-process and `echo` prints directly, once
+        // per shot. `--native`, `--jit` and `--emit-cpp` use the simulator codegen
+        // target, which needs no interpreted run.
+        std::string base = opts.file.substr(0, opts.file.find_last_of('.'));
+        bool compiled = opts.native || opts.jit;
+        if (!opts.emitQasm && !opts.emitCpp && !compiled) {
+            bloch::ExecutionProfiler profiler;
+            {
+                bloch::PhaseTimer::Scope phase(timer, "execute");
+                for (int shot = 0; shot < opts.shots; ++shot) {
+                    bloch::RuntimeEvaluator evaluator;
+                    if (opts.profile)
+                        evaluator.setProfiler(&profiler);
+                    evaluator.setTrace(trace);
+                    evaluator.execute(*program);
+                }
+            }
+            if (opts.profile) {
+                std::cout.flush();
+                std::cerr << profiler.report();
+                std::ofstream(base + ".folded") << profiler.collapsedStacks();
+            }
+            return 0;
+        }
+
+        // Every requested artifact is written before deciding whether to stop.
+        // The classical target replaces measurements with the outcomes of one
+        // interpreted run, so it shares that run with --emit-qasm.
+        bool classical = opts.emitCpp && opts.target == bloch::CppTarget::Classical;
+        std::string qasm;
+        std::unordered_map<const bloch::Expression*, int> measurements;
+        if (opts.emitQasm || classical) {
+            std::ostream discard(nullptr);
+            bloch::RuntimeEvaluator evaluator(discard);
+            timer.measure("execute", [&] { evaluator.execute(*program); });
+            qasm = evaluator.getQasm();
+            measurements = evaluator.measurements();
+        }
+        if (opts.emitQasm) {
+            std::ofstream qfile(base + ".qasm");
+            qfile << qasm;
+        }
+        std::string cpp;
+        if (classical) {
+            bloch::CppGenerator gen(measurements);
+            cpp = timer.measure("codegen", [&] { return gen.generate(*program); });
+        } else if (opts.emitCpp || compiled) {
+            bloch::CppGeneratorOptions genOptions;
+            genOptions.target = bloch::CppTarget::NativeSimulator;
+            genOptions.specialiseQubits = opts.specialiseQubits;
+            genOptions.sharedLibrary = opts.jit;
+            bloch::CppGenerator gen(genOptions);
+            cpp = timer.measure("codegen", [&] { return gen.generate(*program); });
+        }
+        if (opts.emitCpp) {
+            std::ofstream cfile(base + ".cpp");
+            cfile << cpp;
+        }
+        if (!compiled) {
+            std::cout << (opts.emitQasm ? qasm : cpp);
+            return 0;
+        }
+
+        bloch::BuildCache cache(bloch::BuildCache::defaultDirectory());
+        if (opts.jit) {
+            bloch::Jit jitCompiler(opts.compile, opts.useCache ? &cache : nullptr);
+            auto loaded = timer.measure("jit-load", [&] { return jitCompiler.load(cpp); });
+            return timer.measure("run", [&] { return loaded->run(opts.shots); });
+        }
+
+        std::string out = base + ".out";
+        std::string run = "./" + out;
+        bloch::NativeCompiler compiler(opts.compile);
+        // the profile-guided training run uses the requested shots
+        std::string training = "--shots " + std::to_string(opts.shots);
+        std::string key = bloch::BuildCache::key(cpp, compiler.fingerprint(training));
+        auto cached = opts.useCache ? cache.lookup(key) : std::nullopt;
+        if (cached) {
+            run = "\"" + cached->string() + "\"";
+        } else {
+            bloch::PhaseTimer::Scope phase(timer, "compile");
+            std::ofstream cfile(base + ".cpp");
+            cfile << cpp;
+            cfile.close();
+            if (!compiler.compile(base + ".cpp", out, training)) {
+                std::cerr << "Failed to compile generated C++\n";
+                return 1;
+            }
+            if (opts.useCache)
+                cache.store(key, out);
+        }
+        run += " --shots " + std::to_string(opts.shots);
+        int status = timer.measure("run", [&] { return std::system(run.c_str()); });
+        if (status == -1 || !WIFEXITED(status)) {
+            if (status != -1 && WIFSIGNALED(status))
+                std::cerr << "Native program killed by signal " << WTERMSIG(status) << "\n";
+            else
+                std::cerr << "Failed to run native program\n";
+            return 1;
+        }
+        return WEXITSTATUS(status);
+    }
+}
 
 int main(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << "Usage: bloch [--emit-qasm|--emit-cpp] <file.bloch>\n";
+        std::cerr << "Usage: bloch [--run|--native|--jit] [--emit-qasm|--emit-cpp] [--shots N] "
+                     "[--target=native|classical] [--specialise-qubits] [-O0|-O1|-O2|-O3] "
+                     "[-march=native] [--pgo] "
+                     "[--opt-stats] [--profile] [--time-phases[=json]] [--trace out.json] "
+                     "[--no-cache] <file.bloch>\n";
         return 1;
     }
-    bool emitQasm = false;
-    bool emitCpp = false;
-    std::string file;
+    CliOptions opts;
+    opts.compile.linkRuntime = true;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--emit-qasm")
-            emitQasm = true;
+            opts.emitQasm = true;
         else if (arg == "--emit-cpp")
-            emitCpp = true;
+            opts.emitCpp = true;
+        else if (arg == "--run")
+            opts.native = opts.jit = false;
+        else if (arg == "--native")
+            opts.native = true, opts.jit = false;
+        else if (arg == "--jit")
+            opts.jit = true, opts.native = false;
+        else if (arg == "--target=native")
+            opts.target = bloch::CppTarget::NativeSimulator;
+        else if (arg == "--target=classical")
+            opts.target = bloch::CppTarget::Classical;
+        else if (arg.rfind("--target=", 0) == 0) {
+            std::cerr << "Unknown target " << arg.substr(9) << "; expected native or classical\n";
+            return 1;
+        } else if (arg == "--specialise-qubits")
+            opts.specialiseQubits = true;
+        else if (arg.size() == 3 && arg.compare(0, 2, "-O") == 0 && arg[2] >= '0' && arg[2] <= '3')
+            opts.compile.optLevel = arg[2] - '0';
+        else if (arg == "-march=native")
+            opts.compile.nativeArch = true;
+        else if (arg == "--pgo")
+            opts.compile.profileGuided = true;
+        else if (arg == "--profile")
+            opts.profile = true, opts.native = opts.jit = false;
+        else if (arg == "--opt-stats")
+            opts.optStats = true;
+        else if (arg == "--time-phases" || arg == "--time-phases=text")
+            opts.phaseReport = PhaseReport::Text;
+        else if (arg == "--time-phases=json")
+            opts.phaseReport = PhaseReport::Json;
+        else if (arg == "--trace" && i + 1 < argc)
+            opts.tracePath = argv[++i];
+        else if (arg == "--no-cache")
+            opts.useCache = false;
+        else if (arg == "--shots" && i + 1 < argc)
+            opts.shots = std::atoi(argv[++i]);
         else
-            file = arg;
+            opts.file = arg;
     }
-    if (file.empty()) {
+    if (opts.file.empty()) {
         std::cerr << "No input file provided\n";
         return 1;
     }
-    std::ifstream in(file);
-    if (!in) {
-        std::cerr << "Failed to open " << file << "\n";
+    if (opts.target == bloch::CppTarget::Classical && (opts.native || opts.jit)) {
+        std::cerr << "--target=classical output has no simulator and cannot be run with "
+                     "--native or --jit\n";
         return 1;
     }
-    std::string src((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    bloch::PhaseTimer timer;
+    std::unique_ptr<bloch::TraceRecorder> trace;
+    if (!opts.tracePath.empty()) {
+        trace = std::make_unique<bloch::TraceRecorder>();
+        timer.setTrace(trace.get());
+    }
+    int status;
     try {
-        bloch::Lexer lexer(src);
-        auto tokens = lexer.tokenize();
-        bloch::Parser parser(std::move(tokens));
-        auto program = parser.parse();
-        bloch::SemanticAnalyser analyser;
-        analyser.analyse(*program);
-        bloch::RuntimeEvaluator evaluator;
-        evaluator.execute(*program);
-        std::string qasm = evaluator.getQasm();
-        bloch::CppGenerator gen(evaluator.measurements());
-        std::string cpp = gen.generate(*program);
-        std::string base = file.substr(0, file.find_last_of('.'));
-        std::ofstream qfile(base + ".qasm");
-        qfile << qasm;
-        qfile.close();
-        std::ofstream cfile(base + ".cpp");
-        cfile << cpp;
-        cfile.close();
-        if (emitQasm) {
-            std::cout << qasm;
-            return 0;
-        }
-        if (emitCpp) {
-            std::cout << cpp;
-            return 0;
-        }
-        std::string out = base + ".out";
-        std::string cmd = "g++ -std=c++17 " + base + ".cpp -o " + out;
-        if (std::system(cmd.c_str()) != 0) {
-            std::cerr << "Failed to compile generated C++\n";
-            return 1;
-        }
-        std::system(("./" + out).c_str());
+        // the source outlives the tokens and AST that view it
+        auto source = timer.measure("read", [&] { return bloch::SourceFile(opts.file); });
+        status = compileAndRun(opts, source.text(), timer, trace.get());
     } catch (const std::exception& ex) {
         std::cerr << ex.what() << std::endl;
-        return 1;
+        status = 1;
+    }
+    // the report goes to stderr so it never mixes with program output
+    std::cout.flush();
+    if (opts.phaseReport == PhaseReport::Text)
+        std::cerr << timer.text();
+    else if (opts.phaseReport == PhaseReport::Json)
+        std::cerr << timer.json();
+    if (trace) {
+        std::ofstream traceFile(opts.tracePath);
+        traceFile << trace->json();
+        if (!traceFile)
+            std::cerr << "Failed to write " << opts.tracePath << "\n";
     }
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
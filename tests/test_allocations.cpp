@@ -0,0 +1,68 @@
+// Replaces the global allocation functions, so these tests build into their
+// own executable rather than hooking every allocation in bloch_tests.
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "bloch/lexer/lexer.hpp"
+#include "bloch/parser/parser.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/semantics/semantic_analyser.hpp"
+
+using namespace bloch;
+
+namespace {
+    std::atomic<bool> g_counting{false};
+    std::atomic<size_t> g_allocations{0};
+
+    // Counts global allocations made while it is alive
+    class AllocationCounter {
+       public:
+        AllocationCounter() {
+            g_allocations = 0;
+            g_counting = true;
+        }
+        ~AllocationCounter() { g_counting = false; }
+        AllocationCounter(const AllocationCounter&) = delete;
+        AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+        size_t count() const { return g_allocations.load(); }
+    };
+}
+
+void* operator new(std::size_t size) {
+    if (g_counting.load(std::memory_order_relaxed))
+        ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+// Not inlined, so GCC does not see free() applied to a pointer from a new
+// expression and warn about a mismatch (-Wmismatched-new-delete)
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static size_t allocationsForCalls(int calls) {
+    const std::string src =
+        "function inc(int v, int step) -> int { int next = v + step; return next; } "
+        "function main() -> void { int total = 0; for (int i = 0; i < " +
+        std::to_string(calls) + "; i = i + 1) { total = inc(inc(total, 1), i); } }";
+    Lexer lexer(src);
+    Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    AllocationCounter counter;
+    {
+        RuntimeEvaluator eval;
+        eval.execute(*program);
+    }
+    return counter.count();
+}
+
+TEST(RuntimeTest, SteadyStateCallsDoNotAllocate) {
+    // only evaluator setup allocates, so the count must not grow with the call count
+    EXPECT_EQ(allocationsForCalls(10), allocationsForCalls(1000));
+}
@@ -34,13 +34,48 @@ TEST(ASTTest, FunctionDeclarationBasics) {
 TEST(ASTTest, ExpressionNodes) {
     auto left = std::make_unique<LiteralExpression>("1", "int");
     auto right = std::make_unique<LiteralExpression>("2", "int");
-    BinaryExpression expr("+", std::move(left), std::move(right));
+    BinaryExpression expr(BinaryOp::Add, std::move(left), std::move(right));
 
-    EXPECT_EQ(expr.op, "+");
+    EXPECT_EQ(expr.op, BinaryOp::Add);
     auto* leftLit = dynamic_cast<LiteralExpression*>(expr.left.get());
     auto* rightLit = dynamic_cast<LiteralExpression*>(expr.right.get());
     ASSERT_NE(leftLit, nullptr);
     ASSERT_NE(rightLit, nullptr);
     EXPECT_EQ(leftLit->value, "1");
     EXPECT_EQ(rightLit->value, "2");
-}
\ No newline at end of file
+}
+
+TEST(ASTTest, ArenaPlacesNodesInCreationOrder) {
+    Program prog;
+    std::unique_ptr<BlockStatement> first;
+    std::unique_ptr<ReturnStatement> second;
+    {
+        AstArena::Scope scope(prog.arena.get());
+        first = std::make_unique<BlockStatement>();
+        second = std::make_unique<ReturnStatement>();
+    }
+    auto heap = std::make_unique<BlockStatement>();
+
+    EXPECT_EQ(prog.arena->chunks(), 1u);
+    EXPECT_GE(prog.arena->bytesUsed(), sizeof(BlockStatement) + sizeof(ReturnStatement));
+    auto gap = reinterpret_cast<const char*>(second.get()) -
+               reinterpret_cast<const char*>(first.get());
+    EXPECT_GT(gap, 0);
+    EXPECT_LE(gap, static_cast<std::ptrdiff_t>(sizeof(BlockStatement) + 32));
+    EXPECT_EQ(AstArena::current(), nullptr);
+
+    // arena nodes are destroyed normally; their memory goes with the arena
+    first->statements.push_back(std::move(heap));
+    first.reset();
+    second.reset();
+}
+
+TEST(ASTTest, ArenaGrowsPastOneChunk) {
+    AstArena arena;
+    for (size_t used = 0; used <= AstArena::kChunkBytes; used += 64) (void)arena.allocate(64);
+    EXPECT_EQ(arena.chunks(), 2u);
+    void* large = arena.allocate(AstArena::kChunkBytes * 2);
+    EXPECT_NE(large, nullptr);
+    EXPECT_EQ(arena.chunks(), 3u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.allocate(3)) % alignof(std::max_align_t), 0u);
+}
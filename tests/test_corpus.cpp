@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "bloch/lexer/lexer.hpp"
+#include "bloch/parser/parser.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/semantics/semantic_analyser.hpp"
+
+using namespace bloch;
+namespace fs = std::filesystem;
+
+static std::unique_ptr<Program> loadProgram(const fs::path& path) {
+    std::ifstream in(path);
+    std::string src((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    Lexer lexer(src);
+    Parser parser(lexer);
+    auto program = parser.parse();
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    return program;
+}
+
+static std::string runProgram(const std::string& name) {
+    auto program = loadProgram(fs::path(BLOCH_CORPUS_DIR) / (name + ".bloch"));
+    std::ostringstream out;
+    RuntimeEvaluator evaluator(out);
+    evaluator.execute(*program);
+    return out.str();
+}
+
+// Keeps the checked-in corpus valid as the language changes
+TEST(CorpusTest, EveryProgramParsesAndAnalyses) {
+    size_t programs = 0;
+    for (const auto& entry : fs::directory_iterator(BLOCH_CORPUS_DIR)) {
+        if (entry.path().extension() != ".bloch")
+            continue;
+        SCOPED_TRACE(entry.path().filename().string());
+        EXPECT_NO_THROW(loadProgram(entry.path()));
+        ++programs;
+    }
+    EXPECT_GE(programs, 5u);
+}
+
+TEST(CorpusTest, SmallProgramsProduceExpectedOutput) {
+    std::string ghz = runProgram("ghz_8");
+    EXPECT_TRUE(ghz == "0\n" || ghz == "8\n") << ghz;
+    EXPECT_EQ(runProgram("classical_10000"), "884417\n");
+    EXPECT_GE(std::stoi(runProgram("rus_100")), 100);
+}
@@ -1,6 +1,15 @@
 #include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include "bloch/error/bloch_runtime_error.hpp"
+#include "bloch/lexer/keywords.hpp"
 #include "bloch/lexer/lexer.hpp"
+#include "bloch/lexer/source_file.hpp"
+#include "bloch/lexer/symbol.hpp"
 
 using namespace bloch;
 
@@ -113,6 +122,49 @@ TEST(LexerTest, LineAndColumnTracking) {
     EXPECT_EQ(tokens[1].column, 1);
 }
 
+TEST(LexerTest, PositionsSurviveLongWhitespaceRuns) {
+    // runs longer than one vector block, mixing tabs, CRLF and comments
+    std::string src = "a" + std::string(40, ' ') + "b\r\n\t\tc // note\n" +
+                      std::string(70, '\n') + std::string(33, '\t') + "d";
+    Lexer lexer(src);
+    auto tokens = lexer.tokenize();
+
+    ASSERT_EQ(tokens.size(), 5);
+    EXPECT_EQ(tokens[1].line, 1);
+    EXPECT_EQ(tokens[1].column, 42);
+    EXPECT_EQ(tokens[2].line, 2);
+    EXPECT_EQ(tokens[2].column, 3);
+    EXPECT_EQ(tokens[3].value, "d");
+    EXPECT_EQ(tokens[3].line, 73);
+    EXPECT_EQ(tokens[3].column, 34);
+    EXPECT_EQ(tokens[4].type, TokenType::Eof);
+    EXPECT_EQ(tokens[4].column, 35);
+}
+
+TEST(LexerTest, MultiLineStringStartsWhereItOpens) {
+    Lexer lexer("  \"one\ntwo\" x");
+    auto tokens = lexer.tokenize();
+
+    ASSERT_GE(tokens.size(), 2);
+    EXPECT_EQ(tokens[0].line, 1);
+    EXPECT_EQ(tokens[0].column, 3);
+    EXPECT_EQ(tokens[1].line, 2);
+    EXPECT_EQ(tokens[1].column, 6);
+}
+
+TEST(LexerTest, ErrorsReportTheirPosition) {
+    std::string src = "int x;\n" + std::string(20, ' ') + "\"ab";
+    Lexer lexer(src);
+
+    try {
+        (void)lexer.tokenize();
+        FAIL() << "expected a lexer error";
+    } catch (const BlochRuntimeError& e) {
+        EXPECT_EQ(e.line, 2);
+        EXPECT_EQ(e.column, 24);
+    }
+}
+
 TEST(LexerTest, SkipsComments) {
     Lexer lexer("int x // comment\ny");
     auto tokens = lexer.tokenize();
@@ -123,4 +175,128 @@ TEST(LexerTest, SkipsComments) {
     EXPECT_EQ(tokens[1].value, "x");
     EXPECT_EQ(tokens[2].type, TokenType::Identifier);
     EXPECT_EQ(tokens[2].value, "y");
-}
\ No newline at end of file
+}
+
+TEST(LexerTest, TokensViewTheSource) {
+    std::string src = "function main() -> void { int x = 42; echo(\"hi\"); }";
+    Lexer lexer(src);
+    auto tokens = lexer.tokenize();
+
+    const char* begin = src.data();
+    const char* end = begin + src.size();
+    for (const auto& token : tokens) {
+        // operators and punctuation view static spellings instead
+        if (token.type != TokenType::Identifier && token.type != TokenType::IntegerLiteral &&
+            token.type != TokenType::StringLiteral)
+            continue;
+        EXPECT_GE(token.value.data(), begin) << token.value;
+        EXPECT_LE(token.value.data() + token.value.size(), end) << token.value;
+    }
+    EXPECT_EQ(tokens[1].value.data(), begin + 9);
+    EXPECT_EQ(tokens[1].value, "main");
+}
+
+TEST(SourceFileTest, MapsRegularFiles) {
+    std::string path = "source_file_test_" + std::to_string(::getpid()) + ".bloch";
+    std::ofstream(path) << "int x = 1;";
+    {
+        SourceFile source(path);
+        EXPECT_TRUE(source.mapped());
+        EXPECT_EQ(source.text(), "int x = 1;");
+
+        SourceFile moved(std::move(source));
+        EXPECT_EQ(moved.text(), "int x = 1;");
+        Lexer lexer(moved.text());
+        EXPECT_EQ(lexer.tokenize().size(), 6u);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(SourceFileTest, ReadsFilesThatCannotBeMapped) {
+    std::string path = "source_file_empty_" + std::to_string(::getpid()) + ".bloch";
+    std::ofstream{path};
+    {
+        SourceFile empty(path);
+        EXPECT_FALSE(empty.mapped());
+        EXPECT_TRUE(empty.text().empty());
+    }
+    std::remove(path.c_str());
+
+    // procfs reports a size of zero, so the contents are read until EOF
+    SourceFile status("/proc/self/status");
+    EXPECT_FALSE(status.mapped());
+    EXPECT_EQ(status.text().substr(0, 5), "Name:");
+}
+
+TEST(SourceFileTest, MissingFileThrows) {
+    EXPECT_THROW(SourceFile("does_not_exist.bloch"), std::runtime_error);
+}
+
+TEST(LexerTest, NextMatchesTokenize) {
+    const char* src = "int x = 3; // done\nx = x + 1;";
+    Lexer whole(src);
+    auto tokens = whole.tokenize();
+
+    Lexer streamed(src);
+    for (const auto& expected : tokens) {
+        Token token = streamed.next();
+        EXPECT_EQ(token.type, expected.type);
+        EXPECT_EQ(token.value, expected.value);
+        EXPECT_EQ(token.line, expected.line);
+        EXPECT_EQ(token.column, expected.column);
+    }
+    EXPECT_EQ(streamed.next().type, TokenType::Eof);
+}
+
+TEST(SymbolTest, InternsEachSpellingOnce) {
+    Symbol a("alpha");
+    Symbol b(std::string("alp") + "ha");
+    Symbol c("beta");
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.id(), b.id());
+    EXPECT_FALSE(a == c);
+    EXPECT_EQ(a.str(), "alpha");
+    EXPECT_EQ(a, "alpha");
+    EXPECT_TRUE(Symbol().empty());
+    EXPECT_EQ(Symbol(""), Symbol());
+    EXPECT_EQ("x_" + a + "_y", "x_alpha_y");
+
+    // ids and spellings stay stable as the table grows
+    size_t before = Symbol::count();
+    std::vector<Symbol> symbols;
+    for (int i = 0; i < 5000; ++i) symbols.emplace_back("interned_" + std::to_string(i));
+    EXPECT_EQ(Symbol::count(), before + 5000);
+    EXPECT_EQ(symbols[1234], Symbol("interned_1234"));
+    EXPECT_EQ(symbols[1234].str(), "interned_1234");
+    EXPECT_EQ(a.str(), "alpha");
+}
+
+TEST(LexerTest, IdentifiersCarryTheirSymbol) {
+    Lexer lexer("int count = count + other;");
+    auto tokens = lexer.tokenize();
+
+    EXPECT_TRUE(tokens[0].symbol.empty());
+    EXPECT_EQ(tokens[1].symbol, Symbol("count"));
+    EXPECT_EQ(tokens[1].symbol, tokens[3].symbol);
+    EXPECT_FALSE(tokens[1].symbol == tokens[5].symbol);
+}
+
+TEST(LexerTest, RecognisesEveryKeyword) {
+    for (const Keyword& keyword : kKeywords) {
+        Lexer lexer(keyword.text);
+        auto tokens = lexer.tokenize();
+        ASSERT_EQ(tokens.size(), 2u) << keyword.text;
+        EXPECT_EQ(tokens[0].type, keyword.type) << keyword.text;
+    }
+}
+
+TEST(LexerTest, NearMissKeywordsAreIdentifiers) {
+    for (const char* word : {"integer", "in", "Int", "forr", "fo", "method", "membersx", "echo_",
+                             "qubits", "x", "privat", "quantum1", "function_"}) {
+        Lexer lexer(word);
+        auto tokens = lexer.tokenize();
+        ASSERT_EQ(tokens.size(), 2u) << word;
+        EXPECT_EQ(tokens[0].type, TokenType::Identifier) << word;
+        EXPECT_EQ(tokens[0].value, word);
+    }
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "bloch/codegen/cpp_generator.hpp"
+#include "bloch/lexer/lexer.hpp"
+#include "bloch/optimiser/inliner.hpp"
+#include "bloch/optimiser/optimiser.hpp"
+#include "bloch/parser/parser.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/semantics/semantic_analyser.hpp"
+
+using namespace bloch;
+
+static std::unique_ptr<Program> analyseProgram(const char* src) {
+    Lexer lexer(src);
+    auto tokens = lexer.tokenize();
+    Parser parser(std::move(tokens));
+    auto program = parser.parse();
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    return program;
+}
+
+static std::unique_ptr<Program> optimiseProgram(const char* src, Optimiser& optimiser) {
+    auto program = analyseProgram(src);
+    optimiser.optimise(*program);
+    return program;
+}
+
+TEST(OptimiserTest, FoldsConstantArithmetic) {
+    Optimiser optimiser;
+    auto program = optimiseProgram("function main() -> void { int x = (2 + 3) * 4; echo(x); }",
+                                   optimiser);
+
+    auto& body = program->functions[0]->body->statements;
+    auto* var = dynamic_cast<VariableDeclaration*>(body[0].get());
+    ASSERT_NE(var, nullptr);
+    auto* lit = dynamic_cast<LiteralExpression*>(var->initializer.get());
+    ASSERT_NE(lit, nullptr);
+    EXPECT_EQ(lit->intValue, 20);
+    EXPECT_EQ(optimiser.stats().foldedExpressions, 3u);
+}
+
+TEST(OptimiserTest, LeavesDivisionByZeroForRuntime) {
+    Optimiser optimiser;
+    auto program = optimiseProgram("function main() -> void { int x = 1 / 0; echo(x); }",
+                                   optimiser);
+
+    auto& body = program->functions[0]->body->statements;
+    auto* var = dynamic_cast<VariableDeclaration*>(body[0].get());
+    ASSERT_NE(var, nullptr);
+    EXPECT_NE(dynamic_cast<BinaryExpression*>(var->initializer.get()), nullptr);
+}
+
+TEST(OptimiserTest, PropagatesFinalValuesAndRemovesDeadBranch) {
+    const char* src =
+        "function main() -> void { final int n = 3; if (n > 5) { echo(1); } else { echo(n); } "
+        "}";
+    Optimiser optimiser;
+    auto program = optimiseProgram(src, optimiser);
+
+    auto& body = program->functions[0]->body->statements;
+    ASSERT_EQ(body.size(), 1u);
+    auto* block = dynamic_cast<BlockStatement*>(body[0].get());
+    ASSERT_NE(block, nullptr);
+    auto* echo = dynamic_cast<EchoStatement*>(block->statements[0].get());
+    ASSERT_NE(echo, nullptr);
+    auto* lit = dynamic_cast<LiteralExpression*>(echo->value.get());
+    ASSERT_NE(lit, nullptr);
+    EXPECT_EQ(lit->intValue, 3);
+
+    const auto& stats = optimiser.stats();
+    EXPECT_EQ(stats.propagatedConstants, 2u);
+    EXPECT_EQ(stats.removedBranches, 1u);
+    EXPECT_EQ(stats.removedVariables, 1u);
+}
+
+TEST(OptimiserTest, RemovesStatementsAfterReturn) {
+    Optimiser optimiser;
+    auto program = optimiseProgram(
+        "function f() -> int { return 1; echo(2); echo(3); } function main() -> void { }",
+        optimiser);
+
+    EXPECT_EQ(program->functions[0]->body->statements.size(), 1u);
+    EXPECT_EQ(optimiser.stats().removedStatements, 2u);
+}
+
+TEST(OptimiserTest, KeepsVariablesWithSideEffects) {
+    const char* src =
+        "@quantum function flip() -> bit { qubit q; h(q); return measure q; } "
+        "function main() -> void { bit unused = flip(); int dead = 4; dead = 5; }";
+    Optimiser optimiser;
+    auto program = optimiseProgram(src, optimiser);
+
+    auto& body = program->functions[1]->body->statements;
+    ASSERT_EQ(body.size(), 1u);
+    auto* var = dynamic_cast<VariableDeclaration*>(body[0].get());
+    ASSERT_NE(var, nullptr);
+    EXPECT_EQ(var->name, "unused");
+    // the unread qubit in flip() must survive as well
+    EXPECT_EQ(program->functions[0]->body->statements.size(), 3u);
+    EXPECT_EQ(optimiser.stats().removedVariables, 1u);
+}
+
+TEST(OptimiserTest, DeadBranchRemovesQuantumOps) {
+    const char* src =
+        "function main() -> void { qubit q; final bit flip = 0; if (flip == 1) { x(q); } "
+        "bit r = measure q; echo(r); }";
+    Optimiser optimiser;
+    auto program = optimiseProgram(src, optimiser);
+    RuntimeEvaluator eval;
+    eval.execute(*program);
+    EXPECT_EQ(eval.getQasm().find("x q[0]"), std::string::npos);
+}
+
+TEST(InlinerTest, InlinesSmallQuantumFunction) {
+    const char* src =
+        "@quantum function prep(qubit q) -> void { h(q); x(q); } "
+        "function main() -> void { qubit a; prep(a); bit r = measure a; echo(r); }";
+    auto program = analyseProgram(src);
+    Inliner inliner;
+    inliner.inlineCalls(*program);
+    EXPECT_EQ(inliner.inlinedCalls(), 1u);
+
+    auto& body = program->functions[1]->body->statements;
+    auto* block = dynamic_cast<BlockStatement*>(body[1].get());
+    ASSERT_NE(block, nullptr);
+    ASSERT_EQ(block->statements.size(), 2u);
+    RuntimeEvaluator eval;
+    eval.execute(*program);
+    EXPECT_NE(eval.getQasm().find("h q[0];\nx q[0];"), std::string::npos);
+}
+
+TEST(InlinerTest, FoldsAcrossInlinedCall) {
+    const char* src =
+        "function twice(int n) -> int { return n * 2; } "
+        "function main() -> void { int x = twice(21); echo(x); }";
+    auto program = analyseProgram(src);
+    Inliner inliner;
+    inliner.inlineCalls(*program);
+    Optimiser optimiser;
+    optimiser.optimise(*program);
+
+    auto& body = program->functions[1]->body->statements;
+    ASSERT_EQ(body.size(), 2u);
+    auto* var = dynamic_cast<VariableDeclaration*>(body[0].get());
+    ASSERT_NE(var, nullptr);
+    auto* lit = dynamic_cast<LiteralExpression*>(var->initializer.get());
+    ASSERT_NE(lit, nullptr);
+    EXPECT_EQ(lit->intValue, 42);
+}
+
+TEST(InlinerTest, SkipsRecursiveAndLargeFunctions) {
+    const char* src =
+        "function count(int n) -> int { if (n > 0) { return count(n - 1); } return 0; } "
+        "function big() -> void { echo(1); echo(2); echo(3); } "
+        "function main() -> void { int c = count(3); big(); echo(c); }";
+    auto program = analyseProgram(src);
+    Inliner inliner(2);
+    inliner.inlineCalls(*program);
+    EXPECT_EQ(inliner.inlinedCalls(), 0u);
+    EXPECT_EQ(program->functions[2]->body->statements.size(), 3u);
+}
+
+TEST(InlinerTest, InlinedProgramProducesSameOutput) {
+    const char* src =
+        "function add(int a, int b) -> int { int s = a + b; return s; } "
+        "function main() -> void { int t = 0; for (int i = 0; i < 4; i = i + 1) "
+        "{ t = add(t, i); } echo(t); }";
+    auto program = analyseProgram(src);
+    Inliner inliner;
+    inliner.inlineCalls(*program);
+    EXPECT_EQ(inliner.inlinedCalls(), 1u);
+
+    testing::internal::CaptureStdout();
+    RuntimeEvaluator eval;
+    eval.execute(*program);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "6\n");
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <limits>
 #include "bloch/error/bloch_runtime_error.hpp"
 #include "bloch/lexer/lexer.hpp"
 #include "bloch/parser/parser.hpp"
@@ -128,7 +129,7 @@ TEST(ParserTest, ParseClassicalFunction) {
 
     auto* bin = dynamic_cast<BinaryExpression*>(ret->value.get());
     ASSERT_NE(bin, nullptr);
-    EXPECT_EQ(bin->op, "+");
+    EXPECT_EQ(bin->op, BinaryOp::Add);
 }
 
 TEST(ParserTest, ParseQuantumFunction) {
@@ -201,14 +202,14 @@ TEST(ParserTest, ExpressionPrecedence) {
     ASSERT_NE(var, nullptr);
     auto* binAdd = dynamic_cast<BinaryExpression*>(var->initializer.get());
     ASSERT_NE(binAdd, nullptr);
-    EXPECT_EQ(binAdd->op, "+");
+    EXPECT_EQ(binAdd->op, BinaryOp::Add);
     auto* leftLit = dynamic_cast<LiteralExpression*>(binAdd->left.get());
     ASSERT_NE(leftLit, nullptr);
     EXPECT_EQ(leftLit->value, "1");
     EXPECT_EQ(leftLit->literalType, "int");
     auto* mul = dynamic_cast<BinaryExpression*>(binAdd->right.get());
     ASSERT_NE(mul, nullptr);
-    EXPECT_EQ(mul->op, "*");
+    EXPECT_EQ(mul->op, BinaryOp::Multiply);
 }
 
 TEST(ParserTest, ParseIfElse) {
@@ -246,11 +247,127 @@ TEST(ParserTest, ParseEqualityOperators) {
     ASSERT_NE(eqVar, nullptr);
     auto* eqBin = dynamic_cast<BinaryExpression*>(eqVar->initializer.get());
     ASSERT_NE(eqBin, nullptr);
-    EXPECT_EQ(eqBin->op, "==");
+    EXPECT_EQ(eqBin->op, BinaryOp::Equal);
 
     auto* neVar = dynamic_cast<VariableDeclaration*>(program->statements[1].get());
     ASSERT_NE(neVar, nullptr);
     auto* neBin = dynamic_cast<BinaryExpression*>(neVar->initializer.get());
     ASSERT_NE(neBin, nullptr);
-    EXPECT_EQ(neBin->op, "!=");
-}
\ No newline at end of file
+    EXPECT_EQ(neBin->op, BinaryOp::NotEqual);
+}
+
+TEST(ParserTest, LiteralValuesAreDecoded) {
+    const char* src = "int a = 42; float b = 2.5f; int c = -7;";
+    Lexer lexer(src);
+    auto tokens = lexer.tokenize();
+    Parser parser(std::move(tokens));
+    auto program = parser.parse();
+
+    ASSERT_EQ(program->statements.size(), 3u);
+
+    auto* intVar = dynamic_cast<VariableDeclaration*>(program->statements[0].get());
+    auto* intLit = dynamic_cast<LiteralExpression*>(intVar->initializer.get());
+    ASSERT_NE(intLit, nullptr);
+    EXPECT_EQ(intLit->kind, LiteralKind::Int);
+    EXPECT_EQ(intLit->intValue, 42);
+
+    auto* floatVar = dynamic_cast<VariableDeclaration*>(program->statements[1].get());
+    auto* floatLit = dynamic_cast<LiteralExpression*>(floatVar->initializer.get());
+    ASSERT_NE(floatLit, nullptr);
+    EXPECT_EQ(floatLit->kind, LiteralKind::Float);
+    EXPECT_DOUBLE_EQ(floatLit->floatValue, 2.5);
+
+    auto* negVar = dynamic_cast<VariableDeclaration*>(program->statements[2].get());
+    auto* neg = dynamic_cast<UnaryExpression*>(negVar->initializer.get());
+    ASSERT_NE(neg, nullptr);
+    EXPECT_EQ(neg->op, UnaryOp::Negate);
+}
+
+TEST(ParserTest, OutOfRangeIntLiteralReportsItsPosition) {
+    Lexer lexer("int a = 1;\nint b = 99999999999;");
+    Parser parser(lexer.tokenize());
+
+    try {
+        (void)parser.parse();
+        FAIL() << "expected an out-of-range error";
+    } catch (const BlochRuntimeError& e) {
+        EXPECT_EQ(e.line, 2);
+        EXPECT_EQ(e.column, 9);
+    }
+}
+
+TEST(ParserTest, LargeFloatLiteralSaturatesItsIntValue) {
+    Lexer lexer("float a = 3000000000.0f;");
+    Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    auto* var = dynamic_cast<VariableDeclaration*>(program->statements[0].get());
+    auto* lit = dynamic_cast<LiteralExpression*>(var->initializer.get());
+    ASSERT_NE(lit, nullptr);
+    EXPECT_DOUBLE_EQ(lit->floatValue, 3000000000.0);
+    EXPECT_EQ(lit->intValue, std::numeric_limits<int>::max());
+}
+
+TEST(ParserTest, StatementsRecordTheirLine) {
+    Lexer lexer(
+        "function main() -> void {\n"
+        "    if (1 == 1) {\n"
+        "        echo(1);\n"
+        "    }\n"
+        "    for (int i = 0; i < 2; i = i + 1) {\n"
+        "        main();\n"
+        "    }\n"
+        "}\n");
+    Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    auto& body = program->functions[0]->body->statements;
+    ASSERT_EQ(body.size(), 2u);
+    auto ifStmt = dynamic_cast<IfStatement*>(body[0].get());
+    ASSERT_NE(ifStmt, nullptr);
+    EXPECT_EQ(ifStmt->line, 2);
+    auto thenBlock = dynamic_cast<BlockStatement*>(ifStmt->thenBranch.get());
+    ASSERT_NE(thenBlock, nullptr);
+    EXPECT_EQ(thenBlock->statements[0]->line, 3);
+    auto forStmt = dynamic_cast<ForStatement*>(body[1].get());
+    ASSERT_NE(forStmt, nullptr);
+    EXPECT_EQ(forStmt->line, 5);
+    auto loopBody = dynamic_cast<BlockStatement*>(forStmt->body.get());
+    ASSERT_NE(loopBody, nullptr);
+    EXPECT_EQ(loopBody->statements[0]->line, 6);
+}
+
+TEST(ParserTest, StreamsTokensFromLexer) {
+    const char* src =
+        "@quantum function flip(qubit q) -> bit { h(q); return measure q; }\n"
+        "function main() -> void {\n"
+        "    int total = 0;\n"
+        "    for (int i = 0; i < 3; i = i + 1) {\n"
+        "        if (i == 1) { total = total + i; } else { echo(\"skip\"); }\n"
+        "    }\n"
+        "}\n";
+    Lexer streamed(src);
+    auto program = Parser(streamed).parse();
+    Lexer buffered(src);
+    auto expected = Parser(buffered.tokenize()).parse();
+
+    ASSERT_EQ(program->functions.size(), expected->functions.size());
+    for (size_t i = 0; i < program->functions.size(); ++i) {
+        auto& fn = *program->functions[i];
+        auto& want = *expected->functions[i];
+        EXPECT_EQ(fn.name, want.name);
+        EXPECT_EQ(fn.annotations.size(), want.annotations.size());
+        EXPECT_EQ(fn.params.size(), want.params.size());
+        ASSERT_EQ(fn.body->statements.size(), want.body->statements.size());
+        for (size_t j = 0; j < fn.body->statements.size(); ++j) {
+            EXPECT_EQ(fn.body->statements[j]->line, want.body->statements[j]->line);
+            EXPECT_EQ(fn.body->statements[j]->column, want.body->statements[j]->column);
+        }
+    }
+}
+
+TEST(ParserTest, StreamedParseReportsErrors) {
+    Lexer lexer("function main() -> void { int x = ; }");
+    Parser parser(lexer);
+    EXPECT_THROW((void)parser.parse(), BlochRuntimeError);
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include "bloch/lexer/lexer.hpp"
+#include "bloch/parser/parser.hpp"
+#include "bloch/profiling/execution_profiler.hpp"
+#include "bloch/profiling/bench_results.hpp"
+#include "bloch/profiling/phase_timer.hpp"
+#include "bloch/profiling/trace_recorder.hpp"
+#include "bloch/runtime/runtime_evaluator.hpp"
+
+using namespace bloch;
+
+TEST(PhaseTimerTest, RecordsPhasesInOrder) {
+    PhaseTimer timer;
+    int value = timer.measure("first", [] { return 42; });
+    { PhaseTimer::Scope phase(timer, "second"); }
+    EXPECT_EQ(value, 42);
+    ASSERT_EQ(timer.phases().size(), 2u);
+    EXPECT_EQ(timer.phases()[0].name, "first");
+    EXPECT_EQ(timer.phases()[1].name, "second");
+    EXPECT_GE(timer.phases()[0].wallMs, 0.0);
+    EXPECT_GT(timer.phases()[0].peakRssKb, 0);
+}
+
+TEST(PhaseTimerTest, RecordsPhaseLeftByException) {
+    PhaseTimer timer;
+    EXPECT_THROW(timer.measure("failing", []() -> int { throw std::runtime_error("x"); }),
+                 std::runtime_error);
+    ASSERT_EQ(timer.phases().size(), 1u);
+    EXPECT_EQ(timer.phases()[0].name, "failing");
+}
+
+TEST(PhaseTimerTest, CountsChildProcesses) {
+    PhaseTimer timer;
+    timer.measure("child", [] {
+        // busy child so its CPU time is measurable
+        return std::system("i=0; while [ $i -lt 20000 ]; do i=$((i+1)); done");
+    });
+    timer.measure("idle", [] {});
+    EXPECT_GT(timer.phases()[0].cpuMs, 0.0);
+    EXPECT_GT(timer.phases()[0].childPeakRssKb, 0);
+    EXPECT_EQ(timer.phases()[1].childPeakRssKb, 0);
+}
+
+TEST(PhaseTimerTest, FormatsTextAndJson) {
+    PhaseTimer timer;
+    timer.measure("lex", [] {});
+    timer.measure("parse", [] {});
+    std::string text = timer.text();
+    EXPECT_NE(text.find("lex"), std::string::npos);
+    EXPECT_NE(text.find("total"), std::string::npos);
+    std::string json = timer.json();
+    EXPECT_EQ(json.rfind("{\"phases\": [{\"name\": \"lex\", \"wall_ms\": ", 0), 0u);
+    EXPECT_NE(json.find("{\"name\": \"parse\""), std::string::npos);
+    EXPECT_NE(json.find("\"child_peak_rss_kb\": 0}]}"), std::string::npos);
+}
+
+static std::unique_ptr<Program> parseProgram(const char* src) {
+    Lexer lexer(src);
+    Parser parser(lexer.tokenize());
+    return parser.parse();
+}
+
+TEST(ExecutionProfilerTest, AttributesWorkToFunctionsAndLines) {
+    const char* src =
+        "@quantum\n"
+        "function flip() -> bit {\n"
+        "    qubit q;\n"
+        "    h(q);\n"
+        "    return measure q;\n"
+        "}\n"
+        "function main() -> void {\n"
+        "    for (int i = 0; i < 3; i = i + 1) {\n"
+        "        bit b = flip();\n"
+        "    }\n"
+        "}\n";
+    auto program = parseProgram(src);
+    ExecutionProfiler profiler;
+    std::ostringstream out;
+    RuntimeEvaluator evaluator(out);
+    evaluator.setProfiler(&profiler);
+    evaluator.execute(*program);
+
+    const auto& flip = profiler.functions().at("flip");
+    EXPECT_EQ(flip.counters.hits, 3u);
+    EXPECT_EQ(flip.counters.gates, 3u);
+    EXPECT_EQ(flip.counters.measurements, 3u);
+    // one allocation, one gate and two measurement passes per call
+    EXPECT_EQ(flip.counters.sweeps, 12u);
+    EXPECT_EQ(profiler.functions().at("main").counters.hits, 1u);
+    EXPECT_EQ(profiler.functions().at("main").counters.gates, 0u);
+    EXPECT_GE(profiler.functions().at("main").totalMs, flip.totalMs);
+
+    EXPECT_EQ(profiler.lines().at({"flip", 4}).gates, 3u);
+    EXPECT_EQ(profiler.lines().at({"flip", 4}).hits, 3u);
+    EXPECT_EQ(profiler.lines().at({"main", 9}).hits, 3u);
+    EXPECT_EQ(profiler.stacks().count("main;flip"), 1u);
+    EXPECT_NE(profiler.report().find("flip:4"), std::string::npos);
+}
+
+TEST(ExecutionProfilerTest, CountsRecursiveCallsOnceInTotalTime) {
+    const char* src =
+        "function down(int n) -> int {\n"
+        "    if (n > 0) {\n"
+        "        return down(n - 1);\n"
+        "    }\n"
+        "    return 0;\n"
+        "}\n"
+        "function main() -> void {\n"
+        "    int r = down(4);\n"
+        "}\n";
+    auto program = parseProgram(src);
+    ExecutionProfiler profiler;
+    RuntimeEvaluator evaluator;
+    evaluator.setProfiler(&profiler);
+    evaluator.execute(*program);
+
+    const auto& down = profiler.functions().at("down");
+    EXPECT_EQ(down.counters.hits, 5u);
+    EXPECT_LE(down.totalMs, profiler.functions().at("main").totalMs);
+    EXPECT_EQ(profiler.stacks().count("main;down;down;down;down;down"), 1u);
+}
+
+TEST(TraceRecorderTest, SamplingKeepsCategoriesBounded) {
+    TraceRecorder trace(8);
+    std::string gate = "h";
+    auto now = TraceRecorder::Clock::now();
+    for (int i = 0; i < 1000; ++i)
+        trace.record(TraceCategory::Gate, gate, now, now);
+    trace.record(TraceCategory::Call, "main", now, now);
+
+    EXPECT_EQ(trace.seen(TraceCategory::Gate), 1000u);
+    EXPECT_LT(trace.kept(TraceCategory::Gate), 8u);
+    EXPECT_GE(trace.kept(TraceCategory::Gate), 4u);
+    EXPECT_EQ(trace.stride(TraceCategory::Gate), 256u);
+    EXPECT_EQ(trace.kept(TraceCategory::Call), 1u);
+    EXPECT_NE(trace.json().find("\"h\": {\"count\": 1000"), std::string::npos);
+}
+
+TEST(TraceRecorderTest, SpanNameOutlivesTheStringItWasBuiltFrom) {
+    TraceRecorder trace;
+    {
+        Symbol name(std::string("temp") + "orary");
+        TraceRecorder::Span span(&trace, TraceCategory::Call, name);
+    }
+    EXPECT_EQ(trace.kept(TraceCategory::Call), 1u);
+    EXPECT_NE(trace.json().find("\"temporary\""), std::string::npos);
+}
+
+TEST(TraceRecorderTest, RecordsPhasesCallsGatesAndMeasurements) {
+    auto program = parseProgram(
+        "@quantum function flip() -> bit { qubit q; h(q); return measure q; }\n"
+        "function main() -> void { bit b = flip(); }");
+    TraceRecorder trace;
+    PhaseTimer timer;
+    timer.setTrace(&trace);
+    {
+        PhaseTimer::Scope phase(timer, "execute");
+        RuntimeEvaluator evaluator;
+        evaluator.setTrace(&trace);
+        evaluator.execute(*program);
+    }
+    EXPECT_EQ(trace.seen(TraceCategory::Phase), 1u);
+    EXPECT_EQ(trace.seen(TraceCategory::Call), 2u);
+    EXPECT_EQ(trace.seen(TraceCategory::Gate), 1u);
+    EXPECT_EQ(trace.seen(TraceCategory::Measure), 1u);
+    std::string json = trace.json();
+    EXPECT_EQ(json.rfind("{\"traceEvents\": [", 0), 0u);
+    EXPECT_NE(json.find("{\"name\": \"flip\", \"cat\": \"call\", \"ph\": \"X\""),
+              std::string::npos);
+    EXPECT_NE(json.find("\"cat\": \"phase\""), std::string::npos);
+    EXPECT_NE(json.find("\"cat\": \"measure\""), std::string::npos);
+}
+
+TEST(BenchResultsTest, StudentTPValueMatchesTables) {
+    EXPECT_NEAR(studentTPValue(0, 10), 1.0, 1e-9);
+    EXPECT_NEAR(studentTPValue(2.228, 10), 0.05, 1e-3);
+    EXPECT_NEAR(studentTPValue(1.96, 1e6), 0.05, 1e-3);
+}
+
+TEST(BenchResultsTest, RoundTripsThroughJson) {
+    BenchmarkResults results;
+    results.label = "abc \"1\"";
+    results.add("ghz_16/execute", "ms", 1.5);
+    results.add("ghz_16/execute", "ms", 1.25);
+    results.add("ghz_16/peak_rss", "kB", 5300);
+    BenchmarkResults parsed = BenchmarkResults::parse(results.json());
+    EXPECT_EQ(parsed.label, results.label);
+    ASSERT_EQ(parsed.benchmarks.size(), 2u);
+    EXPECT_EQ(parsed.benchmarks[0].name, "ghz_16/execute");
+    EXPECT_EQ(parsed.benchmarks[0].samples, (std::vector<double>{1.5, 1.25}));
+    EXPECT_EQ(parsed.find("ghz_16/peak_rss")->unit, "kB");
+    EXPECT_THROW(BenchmarkResults::parse("{\"benchmarks\": [}"), std::runtime_error);
+    EXPECT_THROW(BenchmarkResults::parse("{\"runs\": []}"), std::runtime_error);
+}
+
+TEST(BenchResultsTest, ReadsGoogleBenchmarkRepetitions) {
+    const char* json = R"({
+        "context": {"date": "today", "num_cpus": 1},
+        "benchmarks": [
+            {"name": "BM_H/10", "run_name": "BM_H/10", "run_type": "iteration",
+             "real_time": 100.0, "time_unit": "ns"},
+            {"name": "BM_H/10", "run_name": "BM_H/10", "run_type": "iteration",
+             "real_time": 110.0, "time_unit": "ns"},
+            {"name": "BM_H/10_mean", "run_name": "BM_H/10", "run_type": "aggregate",
+             "aggregate_name": "mean", "real_time": 105.0, "time_unit": "ns"}
+        ]
+    })";
+    BenchmarkResults results = BenchmarkResults::parse(json);
+    ASSERT_EQ(results.benchmarks.size(), 1u);
+    EXPECT_EQ(results.benchmarks[0].name, "BM_H/10");
+    EXPECT_EQ(results.benchmarks[0].unit, "ns");
+    EXPECT_EQ(results.benchmarks[0].samples, (std::vector<double>{100.0, 110.0}));
+}
+
+TEST(BenchResultsTest, ComparisonDetectsSignificantChanges) {
+    BenchmarkResults base, slower;
+    for (double x : {10.0, 10.1, 9.9, 10.05, 9.95}) {
+        base.add("slow", "ms", x);
+        slower.add("slow", "ms", x * 1.2);
+        base.add("same", "ms", x);
+        slower.add("same", "ms", x + (x > 10 ? -0.05 : 0.05));
+    }
+    base.add("single", "ms", 1);
+    slower.add("single", "ms", 2);
+    slower.add("added", "ms", 1);
+
+    auto comparisons = compareBenchmarks(base, slower);
+    ASSERT_EQ(comparisons.size(), 3u);
+    const auto& slow = comparisons[0];
+    EXPECT_EQ(slow.name, "slow");
+    EXPECT_NEAR(slow.change, 0.2, 1e-9);
+    EXPECT_LT(slow.pValue, 0.001);
+    EXPECT_LT(slow.ciLow, 0.2);
+    EXPECT_GT(slow.ciLow, 0.1);
+    EXPECT_GT(slow.ciHigh, 0.2);
+    EXPECT_GT(comparisons[1].pValue, 0.5);
+    EXPECT_FALSE(comparisons[2].testable);
+    EXPECT_NEAR(comparisons[2].change, 1.0, 1e-9);
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
+#include <sstream>
 #include "bloch/codegen/cpp_generator.hpp"
 #include "bloch/lexer/lexer.hpp"
 #include "bloch/parser/parser.hpp"
 #include "bloch/runtime/runtime_evaluator.hpp"
+#include "bloch/runtime/static_state_vector.hpp"
 #include "bloch/semantics/semantic_analyser.hpp"
 
 using namespace bloch;
@@ -44,4 +46,161 @@ TEST(RuntimeTest, CppGenerationOmitsQuantumOps) {
     EXPECT_EQ(cpp.find("h("), std::string::npos);
     EXPECT_EQ(cpp.find("measure"), std::string::npos);
     EXPECT_NE(cpp.find("bool b"), std::string::npos);
-}
\ No newline at end of file
+}
+
+TEST(RuntimeTest, NativeTargetEmitsSimulatorCalls) {
+    const char* src =
+        "@quantum function flip() -> bit { qubit q; h(q); bit r = measure q; return r; } function "
+        "main() -> void { bit b = flip(); echo(b); }";
+    auto program = parseProgram(src);
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    CppGenerator gen(CppTarget::NativeSimulator);
+    std::string cpp = gen.generate(*program);
+    EXPECT_NE(cpp.find("int q = bloch_sim.allocateQubit();"), std::string::npos);
+    EXPECT_NE(cpp.find("bloch_sim.h(q);"), std::string::npos);
+    EXPECT_NE(cpp.find("bool r = bloch_sim.measure(q);"), std::string::npos);
+    EXPECT_NE(cpp.find("void bloch_main()"), std::string::npos);
+    EXPECT_NE(cpp.find("--shots"), std::string::npos);
+}
+
+TEST(RuntimeTest, CppGenerationKeepsParentheses) {
+    const char* src =
+        "function main() -> void { int a = 1; int b = 2; int c = 2; echo((a + b) % c); }";
+    auto program = parseProgram(src);
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    CppGenerator gen(CppTarget::NativeSimulator);
+    std::string cpp = gen.generate(*program);
+    EXPECT_NE(cpp.find("(a + b) % c"), std::string::npos) << cpp;
+}
+
+TEST(RuntimeTest, AllocatingQubitKeepsExistingState) {
+    QasmSimulator sim;
+    int a = sim.allocateQubit();
+    sim.x(a);
+    int b = sim.allocateQubit();
+    EXPECT_EQ(sim.measure(a), 1);
+    EXPECT_EQ(sim.measure(b), 0);
+}
+
+TEST(RuntimeTest, SpecialisedTargetUsesConstantQubits) {
+    const char* src =
+        "@quantum function prep(qubit a, qubit b) -> void { h(a); cx(a, b); } function main() "
+        "-> void { qubit q0; qubit q1; prep(q0, q1); bit r = measure q1; echo(r); }";
+    auto program = parseProgram(src);
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    CppGeneratorOptions options;
+    options.target = CppTarget::NativeSimulator;
+    options.specialiseQubits = true;
+    CppGenerator gen(options);
+    std::string cpp = gen.generate(*program);
+    EXPECT_TRUE(gen.specialised());
+    EXPECT_NE(cpp.find("StaticStateVector<2> bloch_sim;"), std::string::npos);
+    EXPECT_NE(cpp.find("constexpr int q1 = 1;"), std::string::npos);
+    EXPECT_NE(cpp.find("template <int a, int b> void prep()"), std::string::npos);
+    EXPECT_NE(cpp.find("bloch_sim.cx<a, b>();"), std::string::npos);
+    EXPECT_NE(cpp.find("prep<q0, q1>();"), std::string::npos);
+    EXPECT_NE(cpp.find("bloch_sim.measure<q1>()"), std::string::npos);
+}
+
+TEST(RuntimeTest, SpecialisationFallsBackForLoopAllocations) {
+    const char* src =
+        "function main() -> void { for (int i = 0; i < 3; i = i + 1) { qubit q; h(q); "
+        "bit r = measure q; echo(r); } }";
+    auto program = parseProgram(src);
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    CppGeneratorOptions options;
+    options.target = CppTarget::NativeSimulator;
+    options.specialiseQubits = true;
+    CppGenerator gen(options);
+    std::string cpp = gen.generate(*program);
+    EXPECT_FALSE(gen.specialised());
+    EXPECT_NE(cpp.find("bloch_sim.allocateQubit()"), std::string::npos);
+}
+
+TEST(RuntimeTest, StaticStateVectorAppliesGates) {
+    StaticStateVector<3> sv;
+    sv.x<0>();
+    sv.cx<0, 2>();
+    EXPECT_DOUBLE_EQ(std::norm(sv.amplitude(0b101)), 1.0);
+    sv.h<1>();
+    sv.h<1>();
+    sv.y<1>();
+    sv.z<1>();
+    sv.rx<2>(M_PI);
+    sv.ry<2>(M_PI);
+    sv.rz<0>(0.3);
+    // y flips qubit 1, and rx(pi) and ry(pi) each flip qubit 2 up to a phase
+    EXPECT_NEAR(std::norm(sv.amplitude(0b111)), 1.0, 1e-12);
+    EXPECT_EQ(sv.measure<0>(), 1);
+    EXPECT_EQ(sv.measure<1>(), 1);
+    EXPECT_EQ(sv.measure<2>(), 1);
+    sv.reset();
+    EXPECT_EQ(sv.measure<0>(), 0);
+}
+
+TEST(RuntimeTest, ValueIsCompactTaggedUnion) {
+    EXPECT_EQ(sizeof(Value), 16u);
+    EXPECT_TRUE(Value::makeBit(1).truthy());
+    EXPECT_FALSE(Value::makeInt(0).truthy());
+    EXPECT_EQ(Value::makeBit(1).asInt(), 1);
+    EXPECT_DOUBLE_EQ(Value::makeInt(3).asFloat(), 3.0);
+    EXPECT_EQ(Value::makeFloat(2.5).convertTo(Value::Type::Int).asInt(), 2);
+    EXPECT_EQ(Value::makeQubit(4).qubit(), 4);
+    EXPECT_EQ(Value::makeInt(4).qubit(), -1);
+}
+
+TEST(RuntimeTest, MeasuredBitsCompareAsIntegers) {
+    const char* src =
+        "function main() -> void { qubit q; x(q); bit b = measure q; int n = 0; "
+        "if (b == 1) { n = 5; } echo(n); }";
+    auto program = parseProgram(src);
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    RuntimeEvaluator eval;
+    testing::internal::CaptureStdout();
+    eval.execute(*program);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "5\n");
+}
+
+TEST(RuntimeTest, ReturnDoesNotStopCallerLoop) {
+    const char* src =
+        "function one() -> int { return 1; } function main() -> void { int total = 0; "
+        "for (int i = 0; i < 4; i = i + 1) { total = total + one(); } echo(total); }";
+    auto program = parseProgram(src);
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    RuntimeEvaluator eval;
+    testing::internal::CaptureStdout();
+    eval.execute(*program);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "4\n");
+}
+
+TEST(RuntimeTest, ArgumentsDoNotShadowCallerDuringEvaluation) {
+    const char* src =
+        "function add(int a, int b) -> int { return a + b; } function main() -> void { "
+        "int a = 2; int b = 40; echo(add(b, a)); }";
+    auto program = parseProgram(src);
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    RuntimeEvaluator eval;
+    testing::internal::CaptureStdout();
+    eval.execute(*program);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "42\n");
+}
+
+TEST(RuntimeTest, EchoWritesToProvidedStream) {
+    const char* src = "function main() -> void { echo(7); echo(1.5f); }";
+    auto program = parseProgram(src);
+    SemanticAnalyser analyser;
+    analyser.analyse(*program);
+    std::ostringstream out;
+    RuntimeEvaluator eval(out);
+    testing::internal::CaptureStdout();
+    eval.execute(*program);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+    EXPECT_EQ(out.str(), "7\n1.5\n");
+}
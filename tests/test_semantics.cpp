@@ -61,6 +61,37 @@ TEST(SemanticTest, RedeclareInInnerBlockFails) {
     EXPECT_THROW(analyser.analyse(*program), BlochRuntimeError);
 }
 
+TEST(SymbolTableTest, EndScopeRestoresShadowedBindings) {
+    SymbolTable table;
+    Symbol x("x");
+    Symbol y("y");
+    table.beginScope();
+    table.declare(x, false, ValueType::Int);
+    table.beginScope();
+    table.declare(x, true, ValueType::Float);
+    table.declare(y, false, ValueType::Bit);
+    EXPECT_TRUE(table.isFinal(x));
+    EXPECT_EQ(table.getType(x), ValueType::Float);
+    table.endScope();
+
+    EXPECT_FALSE(table.isFinal(x));
+    EXPECT_EQ(table.getType(x), ValueType::Int);
+    EXPECT_FALSE(table.isDeclared(y));
+    table.endScope();
+    EXPECT_FALSE(table.isDeclared(x));
+}
+
+TEST(SymbolTableTest, RedeclaringInOneScopeReplacesTheBinding) {
+    SymbolTable table;
+    Symbol x("x");
+    table.beginScope();
+    table.declare(x, false, ValueType::Int);
+    table.declare(x, false, ValueType::Qubit);
+    EXPECT_EQ(table.getType(x), ValueType::Qubit);
+    table.endScope();
+    EXPECT_FALSE(table.isDeclared(x));
+}
+
 TEST(SemanticTest, FunctionScopeUsesParameters) {
     const char* src = "function foo(int a) -> void { a = 1; }";
     auto program = parseProgram(src);
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <unistd.h>
+#include "bloch/codegen/cpp_generator.hpp"
+#include "bloch/lexer/lexer.hpp"
+#include "bloch/parser/parser.hpp"
+#include "bloch/semantics/semantic_analyser.hpp"
+#include "bloch/toolchain/build_cache.hpp"
+#include "bloch/toolchain/jit.hpp"
+#include "bloch/toolchain/native_compiler.hpp"
+
+using namespace bloch;
+namespace fs = std::filesystem;
+
+namespace {
+    // Fresh cache directory removed at the end of each test
+    struct TempDir {
+        fs::path path;
+        TempDir() {
+            auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+            path = fs::temp_directory_path() /
+                   ("bloch_test_" + std::to_string(::getpid()) + "_" + test->name());
+            fs::remove_all(path);
+            fs::create_directories(path);
+        }
+        ~TempDir() { fs::remove_all(path); }
+    };
+
+    // Sets an environment variable for the guard's lifetime, restoring the
+    // previous value (or its absence) afterwards
+    struct EnvGuard {
+        std::string name;
+        std::optional<std::string> saved;
+        EnvGuard(std::string variable, const char* value) : name(std::move(variable)) {
+            if (const char* old = std::getenv(name.c_str()))
+                saved = old;
+            setenv(name.c_str(), value, 1);
+        }
+        ~EnvGuard() {
+            if (saved)
+                setenv(name.c_str(), saved->c_str(), 1);
+            else
+                unsetenv(name.c_str());
+        }
+    };
+
+    fs::path writeFile(const fs::path& path, size_t bytes) {
+        std::ofstream(path, std::ios::binary) << std::string(bytes, 'x');
+        return path;
+    }
+
+    std::string generateNative(const char* src, bool sharedLibrary = false) {
+        Lexer lexer(src);
+        Parser parser(lexer.tokenize());
+        auto program = parser.parse();
+        SemanticAnalyser analyser;
+        analyser.analyse(*program);
+        CppGeneratorOptions options;
+        options.target = CppTarget::NativeSimulator;
+        options.sharedLibrary = sharedLibrary;
+        CppGenerator gen(options);
+        return gen.generate(*program);
+    }
+
+    std::string runCommand(const std::string& cmd) {
+        std::string output;
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (!pipe)
+            return output;
+        char buffer[256];
+        while (fgets(buffer, sizeof(buffer), pipe)) output += buffer;
+        pclose(pipe);
+        return output;
+    }
+
+    const char* kBellPair =
+        "function main() -> void { qubit a; qubit b; h(a); cx(a, b); "
+        "bit r = measure a; echo(r); }";
+
+    // Runs the bloch executable with `args` on `source`, written to dir/prog.bloch
+    std::string runCli(const fs::path& dir, const std::string& args, const char* source) {
+        fs::path file = dir / "prog.bloch";
+        std::ofstream(file) << source;
+        return runCommand(std::string("\"") + BLOCH_CLI + "\" " + args + " \"" + file.string() +
+                          "\"");
+    }
+}
+
+TEST(BuildCacheTest, KeyDependsOnSourceAndCommand) {
+    std::string key = BuildCache::key("int main() {}", "g++ -std=c++17");
+    EXPECT_EQ(key.size(), 32u);
+    EXPECT_EQ(key, BuildCache::key("int main() {}", "g++ -std=c++17"));
+    EXPECT_NE(key, BuildCache::key("int main() { }", "g++ -std=c++17"));
+    EXPECT_NE(key, BuildCache::key("int main() {}", "g++ -std=c++17 -O2"));
+    EXPECT_NE(BuildCache::key("bc", "a"), BuildCache::key("c", "ab"));
+}
+
+TEST(BuildCacheTest, StoresAndLooksUpExecutables) {
+    TempDir dir;
+    BuildCache cache(dir.path / "cache");
+    std::string key = BuildCache::key("source", "cmd");
+    EXPECT_FALSE(cache.lookup(key));
+
+    auto stored = cache.store(key, writeFile(dir.path / "a.out", 16));
+    ASSERT_TRUE(stored);
+    auto found = cache.lookup(key);
+    ASSERT_TRUE(found);
+    EXPECT_EQ(*found, *stored);
+    EXPECT_EQ(fs::file_size(*found), 16u);
+}
+
+TEST(BuildCacheTest, EvictsLeastRecentlyUsedEntries) {
+    TempDir dir;
+    BuildCache cache(dir.path / "cache", 100);
+    fs::path exe = writeFile(dir.path / "a.out", 40);
+    cache.store("old", exe);
+    cache.store("used", exe);
+    auto past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    fs::last_write_time(cache.entryPath("old"), past);
+    fs::last_write_time(cache.entryPath("used"), past - std::chrono::hours(1));
+    // touching "used" makes "old" the eviction candidate
+    ASSERT_TRUE(cache.lookup("used"));
+
+    cache.store("new", exe);
+    EXPECT_FALSE(fs::exists(cache.entryPath("old")));
+    EXPECT_TRUE(fs::exists(cache.entryPath("used")));
+    EXPECT_TRUE(fs::exists(cache.entryPath("new")));
+}
+
+TEST(NativeCompilerTest, BuildsSimulatorProgramThatRunsShots) {
+    TempDir dir;
+    fs::path source = dir.path / "prog.cpp";
+    fs::path exe = dir.path / "prog.out";
+    std::ofstream(source) << generateNative(
+        "function main() -> void { qubit q; x(q); bit r = measure q; echo(r); }");
+
+    NativeCompileOptions options;
+    options.linkRuntime = true;
+    NativeCompiler compiler(options);
+    ASSERT_TRUE(compiler.compile(source.string(), exe.string()));
+    EXPECT_EQ(runCommand("\"" + exe.string() + "\" --shots 3"), "1\n1\n1\n");
+}
+
+TEST(NativeCompilerTest, CommandReflectsOptionsAndCxx) {
+    NativeCompileOptions options;
+    options.optLevel = 3;
+    options.nativeArch = true;
+    std::string cmd;
+    {
+        EnvGuard cxx("CXX", "clang++");
+        cmd = NativeCompiler(options).command();
+    }
+    EXPECT_EQ(cmd.rfind("clang++ ", 0), 0u);
+    EXPECT_NE(cmd.find(" -O3"), std::string::npos);
+    EXPECT_NE(cmd.find(" -march=native"), std::string::npos);
+    std::string defaultPrefix = NativeCompiler::compilerPath() + " -std=c++17 -O2";
+    EXPECT_EQ(NativeCompiler().command().rfind(defaultPrefix, 0), 0u);
+
+    NativeCompileOptions pgo = options;
+    pgo.profileGuided = true;
+    EXPECT_NE(NativeCompiler(options).fingerprint(), NativeCompiler(pgo).fingerprint());
+    // a profile trained on one workload is not reused for another
+    EXPECT_NE(NativeCompiler(pgo).fingerprint("--shots 1"),
+              NativeCompiler(pgo).fingerprint("--shots 100000"));
+    EXPECT_EQ(NativeCompiler(options).fingerprint("--shots 1"),
+              NativeCompiler(options).fingerprint("--shots 100000"));
+}
+
+TEST(NativeCompilerTest, ProfileGuidedBuildRunsTrainingStep) {
+    TempDir dir;
+    fs::path source = dir.path / "prog.cpp";
+    fs::path exe = dir.path / "prog.out";
+    std::ofstream(source) << generateNative(
+        "function main() -> void { int t = 0; for (int i = 0; i < 1000; i = i + 1) "
+        "{ t = t + i % 7; } echo(t); }");
+
+    NativeCompileOptions options;
+    options.linkRuntime = true;
+    options.profileGuided = true;
+    ASSERT_TRUE(NativeCompiler(options).compile(source.string(), exe.string(), "--shots 2"));
+    EXPECT_FALSE(fs::exists(exe.string() + ".profile"));
+    EXPECT_EQ(runCommand("\"" + exe.string() + "\""), "2997\n");
+}
+
+TEST(JitTest, LoadsSharedObjectAndReusesHandle) {
+    TempDir dir;
+    BuildCache cache(dir.path / "cache");
+    std::string cpp = generateNative(
+        "function main() -> void { qubit q; x(q); bit r = measure q; echo(r); }", true);
+    EXPECT_EQ(cpp.find("int main("), std::string::npos);
+
+    Jit jit(NativeCompileOptions{}, &cache);
+    auto program = jit.load(cpp);
+    testing::internal::CaptureStdout();
+    program->run(2);
+    program->run(1);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "1\n1\n1\n");
+    EXPECT_EQ(jit.load(cpp), program);
+    EXPECT_EQ(jit.loadedPrograms(), 1u);
+
+    // a second host finds the shared object in the build cache
+    Jit other(NativeCompileOptions{}, &cache);
+    testing::internal::CaptureStdout();
+    other.load(cpp)->run(1);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "1\n");
+}
+
+TEST(CliTest, EmitCppDefaultsToNativeTarget) {
+    TempDir dir;
+    std::string cpp = runCli(dir.path, "--emit-cpp", kBellPair);
+    EXPECT_NE(cpp.find("bloch_sim.h(a);"), std::string::npos) << cpp;
+    EXPECT_EQ(cpp, runCli(dir.path, "--emit-cpp --target=native", kBellPair));
+}
+
+TEST(CliTest, ClassicalTargetEmitsStandaloneCpp) {
+    TempDir dir;
+    std::string cpp = runCli(dir.path, "--emit-cpp --target=classical", kBellPair);
+    EXPECT_NE(cpp.find("int main()"), std::string::npos) << cpp;
+    EXPECT_EQ(cpp.find("bloch_sim"), std::string::npos) << cpp;
+    EXPECT_TRUE(fs::exists(dir.path / "prog.cpp"));
+    // classical output has no simulator, so it cannot be built and run
+    std::string error = runCli(dir.path, "--native --target=classical 2>&1", kBellPair);
+    EXPECT_NE(error.find("cannot be run with --native"), std::string::npos) << error;
+}
+
+TEST(CliTest, EmitQasmAndCppWritesBothFiles) {
+    TempDir dir;
+    std::string out = runCli(dir.path, "--emit-qasm --emit-cpp", kBellPair);
+    EXPECT_NE(out.find("OPENQASM"), std::string::npos) << out;
+    EXPECT_TRUE(fs::exists(dir.path / "prog.qasm"));
+    EXPECT_TRUE(fs::exists(dir.path / "prog.cpp"));
+}